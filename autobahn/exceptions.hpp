@@ -61,6 +61,16 @@ class protocol_error : public std::runtime_error {
      protocol_error(const std::string& message) : std::runtime_error(message) {};
 };
 
+class canceled_error : public std::runtime_error {
+  public:
+     canceled_error() : std::runtime_error("call canceled") {};
+};
+
+class timeout_error : public std::runtime_error {
+  public:
+     timeout_error() : std::runtime_error("call timed out") {};
+};
+
 } // namespace autobahn
 
 #endif // AUTOBAHN_EXCEPTIONS_HPP
@@ -0,0 +1,131 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Crossbar.io Technologies GmbH and contributors
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef AUTOBAHN_SPAN_HPP
+#define AUTOBAHN_SPAN_HPP
+
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+
+namespace autobahn {
+
+/*!
+ * A non-owning view of a contiguous sequence of objects, modelled after
+ * C++20 `std::span` with a dynamic extent.
+ *
+ * Used for zero-copy access to binary arguments (`span<const uint8_t>`),
+ * and for packing contiguous arrays of numbers without copying them into
+ * a container first.
+ */
+template <typename T>
+class span
+{
+public:
+    using element_type = T;
+    using value_type = typename std::remove_cv<T>::type;
+    using size_type = std::size_t;
+    using pointer = T*;
+    using reference = T&;
+    using iterator = T*;
+
+    constexpr span() noexcept
+        : m_data(nullptr)
+        , m_size(0)
+    {
+    }
+
+    constexpr span(pointer data, size_type size) noexcept
+        : m_data(data)
+        , m_size(size)
+    {
+    }
+
+    template <std::size_t N>
+    constexpr span(element_type (&array)[N]) noexcept
+        : m_data(array)
+        , m_size(N)
+    {
+    }
+
+    /*!
+     * Constructs a span from a contiguous container like `std::vector` or `std::array`.
+     */
+    template <typename Container,
+              typename = typename std::enable_if<
+                  std::is_convertible<decltype(std::declval<Container&>().data()), pointer>::value>::type>
+    span(Container& container)
+        : m_data(container.data())
+        , m_size(container.size())
+    {
+    }
+
+    template <typename Container,
+              typename = typename std::enable_if<
+                  std::is_convertible<decltype(std::declval<const Container&>().data()), pointer>::value>::type>
+    span(const Container& container)
+        : m_data(container.data())
+        , m_size(container.size())
+    {
+    }
+
+    constexpr pointer data() const noexcept { return m_data; }
+    constexpr size_type size() const noexcept { return m_size; }
+    constexpr bool empty() const noexcept { return m_size == 0; }
+
+    constexpr iterator begin() const noexcept { return m_data; }
+    constexpr iterator end() const noexcept { return m_data + m_size; }
+
+    reference operator[](size_type index) const { return m_data[index]; }
+
+    reference at(size_type index) const
+    {
+        if (index >= m_size) {
+            throw std::out_of_range("span index out of range");
+        }
+        return m_data[index];
+    }
+
+    span subspan(size_type offset, size_type count) const
+    {
+        if (offset > m_size || count > m_size - offset) {
+            throw std::out_of_range("subspan out of range");
+        }
+        return span(m_data + offset, count);
+    }
+
+private:
+    pointer m_data;
+    size_type m_size;
+};
+
+} // namespace autobahn
+
+#endif // AUTOBAHN_SPAN_HPP
@@ -0,0 +1,237 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Crossbar.io Technologies GmbH and contributors
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef AUTOBAHN_WAMP_ADMISSION_CONTROL_HPP
+#define AUTOBAHN_WAMP_ADMISSION_CONTROL_HPP
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace autobahn {
+
+/*!
+ * Counters of the invocations of one registration under admission control,
+ * see wamp_admission_control::metrics().
+ */
+class wamp_admission_metrics
+{
+public:
+    /// Queue wait times are counted in power of two microsecond buckets: <2us, <4us, ..., the last one open ended.
+    static const std::size_t NUM_WAIT_TIME_BUCKETS = 16;
+    using wait_time_histogram = std::array<uint64_t, NUM_WAIT_TIME_BUCKETS>;
+
+    wamp_admission_metrics();
+
+    /// Number of invocations started, right away or after queueing.
+    uint64_t admitted() const;
+
+    /// Number of invocations that had to queue for a free slot.
+    uint64_t queued() const;
+
+    /// Number of invocations rejected because the queue was full.
+    uint64_t rejected_queue_full() const;
+
+    /// Number of invocations rejected because they queued longer than allowed.
+    uint64_t rejected_queue_delay() const;
+
+    /// Number of invocations rejected for either reason.
+    uint64_t rejected() const;
+
+    /// Invocations running when the metrics were taken.
+    std::size_t running() const;
+
+    /// Invocations queued when the metrics were taken.
+    std::size_t queue_length() const;
+
+    /// Number of queued invocations started by the time they waited.
+    const wait_time_histogram& wait_times() const;
+
+    //
+    // functions only called internally by wamp_admission_control
+
+    void record_admitted();
+    void record_queued();
+    void record_rejected_queue_full();
+    void record_rejected_queue_delay();
+    void record_wait(const std::chrono::microseconds& wait);
+    void set_load(std::size_t running, std::size_t queue_length);
+
+private:
+    uint64_t m_admitted;
+    uint64_t m_queued;
+    uint64_t m_rejected_queue_full;
+    uint64_t m_rejected_queue_delay;
+    std::size_t m_running;
+    std::size_t m_queue_length;
+    wait_time_histogram m_wait_times;
+};
+
+class wamp_admission_slot;
+
+/*!
+ * Limits how many invocations of a registration run at once, see
+ * wamp_session::provide().
+ *
+ * Invocations beyond the concurrency limit wait in a bounded queue and start
+ * as running ones reply. Invocations that find the queue full, or that wait
+ * longer than the maximum queueing delay, are rejected with the configured
+ * error URI instead of piling up in memory.
+ *
+ * Copies of a control refer to the same limits and counters.
+ */
+class wamp_admission_control
+{
+public:
+    /// Constructs an empty control, which admits everything.
+    wamp_admission_control();
+
+    /*!
+     * \param max_concurrency The number of invocations running at once.
+     * \param max_queue_length The number of invocations waiting for a slot. Zero rejects right away.
+     * \param max_queue_delay How long an invocation may wait for a slot. Zero for no limit.
+     * \param reject_uri The error URI rejected invocations are answered with.
+     */
+    explicit wamp_admission_control(
+            std::size_t max_concurrency,
+            std::size_t max_queue_length = 0,
+            const std::chrono::microseconds& max_queue_delay = std::chrono::microseconds(0),
+            const std::string& reject_uri = "wamp.error.unavailable");
+
+    explicit operator bool() const;
+
+    std::size_t max_concurrency() const;
+    std::size_t max_queue_length() const;
+    const std::chrono::microseconds& max_queue_delay() const;
+    const std::string& reject_uri() const;
+
+    /// A snapshot of the counters.
+    wamp_admission_metrics metrics() const;
+
+    /// Whether both controls refer to the same limits and counters.
+    bool operator==(const wamp_admission_control& other) const;
+    bool operator!=(const wamp_admission_control& other) const;
+
+    //
+    // functions only called internally by wamp_session
+
+    enum class decision
+    {
+        start,
+        queued,
+        rejected
+    };
+
+    /// Started with the slot held by a queued invocation once it is admitted.
+    using start_fn = std::function<void(const std::shared_ptr<wamp_admission_slot>&)>;
+
+    /// Run for a queued invocation that waited too long.
+    using reject_fn = std::function<void()>;
+
+    /*!
+     * Admits an invocation. On start, @p slot is set and must be held until
+     * the invocation has replied; on queued, @p start or @p reject runs later.
+     */
+    decision admit(start_fn&& start, reject_fn&& reject, std::shared_ptr<wamp_admission_slot>& slot) const;
+
+    /// Rejects the queued invocations that waited longer than the maximum queueing delay.
+    void reject_expired() const;
+
+    /*!
+     * The time by which the oldest queued invocation is rejected unless a slot
+     * frees up. False if nothing is queued or the queueing delay is unlimited.
+     */
+    bool next_deadline(std::chrono::steady_clock::time_point& deadline) const;
+
+private:
+    friend class wamp_admission_slot;
+
+    struct queued_invocation
+    {
+        std::chrono::steady_clock::time_point m_enqueued;
+        start_fn m_start;
+        reject_fn m_reject;
+    };
+
+    struct state
+    {
+        std::size_t m_max_concurrency;
+        std::size_t m_max_queue_length;
+        std::chrono::microseconds m_max_queue_delay;
+        std::string m_reject_uri;
+
+        std::mutex m_mutex;
+        std::size_t m_running;
+        std::deque<queued_invocation> m_queue;
+        wamp_admission_metrics m_metrics;
+    };
+
+    static void release(const std::shared_ptr<state>& admission);
+
+    /// Takes the expired invocations off the head of the queue; the lock must be held.
+    static void take_expired(
+            state& admission, const std::chrono::steady_clock::time_point& now, std::vector<reject_fn>& expired);
+
+    /// Runs the rejections taken off the queue, without the lock held.
+    static void run_rejects(std::vector<reject_fn>& expired);
+
+    std::shared_ptr<state> m_state;
+};
+
+/// A running invocation's hold on one of the slots of a wamp_admission_control.
+class wamp_admission_slot
+{
+public:
+    ~wamp_admission_slot();
+
+    wamp_admission_slot(const wamp_admission_slot&) = delete;
+    wamp_admission_slot& operator=(const wamp_admission_slot&) = delete;
+
+private:
+    friend class wamp_admission_control;
+
+    explicit wamp_admission_slot(const std::shared_ptr<wamp_admission_control::state>& admission);
+
+    std::shared_ptr<wamp_admission_control::state> m_admission;
+};
+
+} // namespace autobahn
+
+#include "wamp_admission_control.ipp"
+
+#endif // AUTOBAHN_WAMP_ADMISSION_CONTROL_HPP
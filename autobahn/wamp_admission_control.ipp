@@ -0,0 +1,327 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Crossbar.io Technologies GmbH and contributors
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include <utility>
+
+namespace autobahn {
+
+inline wamp_admission_metrics::wamp_admission_metrics()
+    : m_admitted(0)
+    , m_queued(0)
+    , m_rejected_queue_full(0)
+    , m_rejected_queue_delay(0)
+    , m_running(0)
+    , m_queue_length(0)
+    , m_wait_times()
+{
+}
+
+inline uint64_t wamp_admission_metrics::admitted() const
+{
+    return m_admitted;
+}
+
+inline uint64_t wamp_admission_metrics::queued() const
+{
+    return m_queued;
+}
+
+inline uint64_t wamp_admission_metrics::rejected_queue_full() const
+{
+    return m_rejected_queue_full;
+}
+
+inline uint64_t wamp_admission_metrics::rejected_queue_delay() const
+{
+    return m_rejected_queue_delay;
+}
+
+inline uint64_t wamp_admission_metrics::rejected() const
+{
+    return m_rejected_queue_full + m_rejected_queue_delay;
+}
+
+inline std::size_t wamp_admission_metrics::running() const
+{
+    return m_running;
+}
+
+inline std::size_t wamp_admission_metrics::queue_length() const
+{
+    return m_queue_length;
+}
+
+inline const wamp_admission_metrics::wait_time_histogram& wamp_admission_metrics::wait_times() const
+{
+    return m_wait_times;
+}
+
+inline void wamp_admission_metrics::record_admitted()
+{
+    ++m_admitted;
+}
+
+inline void wamp_admission_metrics::record_queued()
+{
+    ++m_queued;
+}
+
+inline void wamp_admission_metrics::record_rejected_queue_full()
+{
+    ++m_rejected_queue_full;
+}
+
+inline void wamp_admission_metrics::record_rejected_queue_delay()
+{
+    ++m_rejected_queue_delay;
+}
+
+inline void wamp_admission_metrics::record_wait(const std::chrono::microseconds& wait)
+{
+    uint64_t micros = wait.count() > 0 ? static_cast<uint64_t>(wait.count()) : 0;
+
+    std::size_t bucket = 0;
+    while (micros > 1 && bucket + 1 < NUM_WAIT_TIME_BUCKETS) {
+        micros >>= 1;
+        ++bucket;
+    }
+    ++m_wait_times[bucket];
+}
+
+inline void wamp_admission_metrics::set_load(std::size_t running, std::size_t queue_length)
+{
+    m_running = running;
+    m_queue_length = queue_length;
+}
+
+inline wamp_admission_control::wamp_admission_control()
+    : m_state()
+{
+}
+
+inline wamp_admission_control::wamp_admission_control(
+        std::size_t max_concurrency,
+        std::size_t max_queue_length,
+        const std::chrono::microseconds& max_queue_delay,
+        const std::string& reject_uri)
+    : m_state(std::make_shared<state>())
+{
+    m_state->m_max_concurrency = max_concurrency;
+    m_state->m_max_queue_length = max_queue_length;
+    m_state->m_max_queue_delay = max_queue_delay;
+    m_state->m_reject_uri = reject_uri;
+    m_state->m_running = 0;
+}
+
+inline wamp_admission_control::operator bool() const
+{
+    return m_state != nullptr;
+}
+
+inline std::size_t wamp_admission_control::max_concurrency() const
+{
+    return m_state ? m_state->m_max_concurrency : 0;
+}
+
+inline std::size_t wamp_admission_control::max_queue_length() const
+{
+    return m_state ? m_state->m_max_queue_length : 0;
+}
+
+inline const std::chrono::microseconds& wamp_admission_control::max_queue_delay() const
+{
+    static const std::chrono::microseconds NO_DELAY(0);
+    return m_state ? m_state->m_max_queue_delay : NO_DELAY;
+}
+
+inline const std::string& wamp_admission_control::reject_uri() const
+{
+    static const std::string NO_URI;
+    return m_state ? m_state->m_reject_uri : NO_URI;
+}
+
+inline wamp_admission_metrics wamp_admission_control::metrics() const
+{
+    if (!m_state) {
+        return wamp_admission_metrics();
+    }
+
+    std::lock_guard<std::mutex> lock(m_state->m_mutex);
+    wamp_admission_metrics metrics = m_state->m_metrics;
+    metrics.set_load(m_state->m_running, m_state->m_queue.size());
+    return metrics;
+}
+
+inline bool wamp_admission_control::operator==(const wamp_admission_control& other) const
+{
+    return m_state == other.m_state;
+}
+
+inline bool wamp_admission_control::operator!=(const wamp_admission_control& other) const
+{
+    return m_state != other.m_state;
+}
+
+inline wamp_admission_control::decision wamp_admission_control::admit(
+        start_fn&& start, reject_fn&& reject, std::shared_ptr<wamp_admission_slot>& slot) const
+{
+    slot.reset();
+    if (!m_state) {
+        return decision::start;
+    }
+
+    // Invocations that waited too long make room in the queue first.
+    std::vector<reject_fn> expired;
+    decision result = decision::rejected;
+    {
+        std::lock_guard<std::mutex> lock(m_state->m_mutex);
+        const auto now = std::chrono::steady_clock::now();
+        take_expired(*m_state, now, expired);
+
+        if (m_state->m_running < m_state->m_max_concurrency) {
+            ++m_state->m_running;
+            m_state->m_metrics.record_admitted();
+            slot.reset(new wamp_admission_slot(m_state));
+            result = decision::start;
+        } else if (m_state->m_queue.size() < m_state->m_max_queue_length) {
+            m_state->m_metrics.record_queued();
+            m_state->m_queue.push_back(queued_invocation{now, std::move(start), std::move(reject)});
+            result = decision::queued;
+        } else {
+            m_state->m_metrics.record_rejected_queue_full();
+        }
+    }
+
+    run_rejects(expired);
+    return result;
+}
+
+inline void wamp_admission_control::reject_expired() const
+{
+    if (!m_state) {
+        return;
+    }
+
+    std::vector<reject_fn> expired;
+    {
+        std::lock_guard<std::mutex> lock(m_state->m_mutex);
+        take_expired(*m_state, std::chrono::steady_clock::now(), expired);
+    }
+    run_rejects(expired);
+}
+
+inline bool wamp_admission_control::next_deadline(std::chrono::steady_clock::time_point& deadline) const
+{
+    if (!m_state) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_state->m_mutex);
+    if (m_state->m_queue.empty() || m_state->m_max_queue_delay.count() <= 0) {
+        return false;
+    }
+    deadline = m_state->m_queue.front().m_enqueued + m_state->m_max_queue_delay;
+    return true;
+}
+
+inline void wamp_admission_control::release(const std::shared_ptr<state>& admission)
+{
+    // The freed slot goes to the oldest queued invocation that has not
+    // waited too long; those that have are rejected on the way.
+    std::vector<reject_fn> expired;
+    start_fn next;
+    {
+        std::lock_guard<std::mutex> lock(admission->m_mutex);
+        const auto now = std::chrono::steady_clock::now();
+        take_expired(*admission, now, expired);
+
+        if (!admission->m_queue.empty()) {
+            queued_invocation queued = std::move(admission->m_queue.front());
+            admission->m_queue.pop_front();
+
+            admission->m_metrics.record_admitted();
+            admission->m_metrics.record_wait(
+                    std::chrono::duration_cast<std::chrono::microseconds>(now - queued.m_enqueued));
+            next = std::move(queued.m_start);
+        } else {
+            --admission->m_running;
+        }
+    }
+
+    run_rejects(expired);
+
+    // Runs from the destructor of a slot, so nothing may escape.
+    try {
+        if (next) {
+            next(std::shared_ptr<wamp_admission_slot>(new wamp_admission_slot(admission)));
+        }
+    } catch (...) {
+    }
+}
+
+inline void wamp_admission_control::take_expired(
+        state& admission, const std::chrono::steady_clock::time_point& now, std::vector<reject_fn>& expired)
+{
+    if (admission.m_max_queue_delay.count() <= 0) {
+        return;
+    }
+
+    // The queue is in arrival order, so the expired invocations are at its head.
+    while (!admission.m_queue.empty() && now - admission.m_queue.front().m_enqueued > admission.m_max_queue_delay) {
+        admission.m_metrics.record_rejected_queue_delay();
+        expired.push_back(std::move(admission.m_queue.front().m_reject));
+        admission.m_queue.pop_front();
+    }
+}
+
+inline void wamp_admission_control::run_rejects(std::vector<reject_fn>& expired)
+{
+    // Also runs from the destructor of a slot, so nothing may escape.
+    for (auto& reject : expired) {
+        try {
+            reject();
+        } catch (...) {
+        }
+    }
+}
+
+inline wamp_admission_slot::wamp_admission_slot(
+        const std::shared_ptr<wamp_admission_control::state>& admission)
+    : m_admission(admission)
+{
+}
+
+inline wamp_admission_slot::~wamp_admission_slot()
+{
+    wamp_admission_control::release(m_admission);
+}
+
+} // namespace autobahn
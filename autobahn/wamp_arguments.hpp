@@ -31,11 +31,19 @@
 #ifndef AUTOBAHN_WAMP_ARGUMENTS_HPP
 #define AUTOBAHN_WAMP_ARGUMENTS_HPP
 
+#include "span.hpp"
+
 #include <msgpack/object.hpp>
 #include <msgpack/zone.hpp>
 
+#include <algorithm>
 #include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <limits>
 #include <string>
+#include <type_traits>
 #include <unordered_map>
 #include <vector>
 
@@ -49,9 +57,135 @@ static msgpack::zone EMPTY_KW_ARGUMENTS_ZONE;
 static const msgpack::object EMPTY_ARGUMENTS(std::array<msgpack::object, 0>(), EMPTY_ARGUMENTS_ZONE);
 static const msgpack::object EMPTY_KW_ARGUMENTS(wamp_kw_arguments(), EMPTY_KW_ARGUMENTS_ZONE);
 
+/*!
+ * A key for looking up keyword arguments and details, carrying the key's hash.
+ *
+ * Keys constructed from string literals are constexpr, so keys used on hot paths
+ * can be hashed at compile time and skip `strlen` and hashing on every look-up.
+ * Keys constructed at runtime are hashed only when a look-up uses the hash, i.e.
+ * not for small maps that are scanned.
+ *
+ * Example:
+ * ```
+ * static constexpr autobahn::wamp_key PRICE_KEY("price");
+ * double price = invocation->kw_argument<double>(PRICE_KEY);
+ * ```
+ */
+class wamp_key
+{
+public:
+    /*!
+     * Constructs a key from a string literal, hashed at compile time if used
+     * in a constant expression. Look-ups taking `const char*` keys measure them
+     * with `strlen` instead, so character buffers are never mistaken for literals.
+     */
+    template <std::size_t N>
+    explicit constexpr wamp_key(const char (&key)[N])
+        : m_data(key)
+        , m_size(length(key, N - 1))
+        , m_hash(hash(key, length(key, N - 1)))
+        , m_hashed(true)
+    {
+    }
+
+    /*!
+     * Constructs a key referring to the given characters. The characters must
+     * outlive the key.
+     */
+    wamp_key(const char* key, std::size_t size);
+
+    /*!
+     * Constructs a key referring to the given string. The string must outlive
+     * the key.
+     */
+    explicit wamp_key(const std::string& key);
+
+    constexpr const char* data() const { return m_data; }
+    constexpr std::size_t size() const { return m_size; }
+    constexpr uint64_t hash() const { return m_hashed ? m_hash : runtime_hash(m_data, m_size); }
+
+    std::string str() const;
+
+    /*!
+     * FNV-1a hash of the given characters, usable in constant expressions.
+     */
+    static constexpr uint64_t hash(
+            const char* data, std::size_t size, uint64_t seed = 14695981039346656037ULL)
+    {
+        return size == 0 ? seed
+            : hash(data + 1, size - 1, (seed ^ static_cast<uint8_t>(*data)) * 1099511628211ULL);
+    }
+
+    /*!
+     * FNV-1a hash of the given characters, computed iteratively for keys
+     * only known at runtime.
+     */
+    static uint64_t runtime_hash(const char* data, std::size_t size);
+
+private:
+    /*!
+     * The length of the null terminated string at @p data, at most @p size.
+     */
+    static constexpr std::size_t length(const char* data, std::size_t size)
+    {
+        return size == 0 || *data == '\0' ? 0 : 1 + length(data + 1, size - 1);
+    }
+
+    const char* m_data;
+    std::size_t m_size;
+    uint64_t m_hash;
+    bool m_hashed;
+};
+
+/*!
+ * A hash index over the string keys of a msgpack map, used by events, invocations
+ * and call results to look up keyword arguments and details.
+ *
+ * Small maps are scanned linearly. For maps with more than `LINEAR_SCAN_LIMIT`
+ * entries, an open addressing table is built on the first look-up and reused
+ * by all following look-ups, making them O(1). Building the table is safe when
+ * look-ups race on different threads, e.g. for an event shared by several handlers.
+ *
+ * The index refers to map entries by position, so it must be reset whenever the
+ * indexed map is replaced.
+ */
+class wamp_map_index
+{
+public:
+    static const std::size_t LINEAR_SCAN_LIMIT = 8;
+
+    wamp_map_index();
+    wamp_map_index(wamp_map_index&& other);
+    ~wamp_map_index();
+
+    wamp_map_index(const wamp_map_index& other) = delete;
+    wamp_map_index& operator=(const wamp_map_index& other) = delete;
+    wamp_map_index& operator=(wamp_map_index&& other);
+
+    /*!
+     * Finds the value for the given @p key in the @p map, building the index first if needed.
+     *
+     * @return The value, or nullptr if there is no such key.
+     * @throw msgpack::type_error if @p map is not a map.
+     */
+    const msgpack::object* find(const msgpack::object& map, const wamp_key& key) const;
+
+    /*!
+     * Discards the index. Called whenever the indexed map is replaced.
+     */
+    void reset();
+
+private:
+    struct table;
+
+    static const msgpack::object* scan(const msgpack::object& map, const wamp_key& key);
+    static table* build(const msgpack::object& map);
+
+    mutable std::atomic<table*> m_table;
+};
+
 
 //msgpack map utilities.
-//TODO: refactor event & invocation to used these
 template <typename T>
 inline T value_for_key(const msgpack::object& object, const std::string& key)
 {
@@ -121,6 +255,173 @@ inline T value_for_key_or(const msgpack::object& object, const char* key, const
     }
     return fallback;
 }
+
+/*!
+ * Element types of numeric arrays that are decoded by decode_numeric_array() and
+ * packed from spans as msgpack arrays. Single byte types are excluded, since
+ * containers and spans of those map to msgpack binaries.
+ */
+template <typename T>
+struct is_numeric_array_element : std::integral_constant<bool,
+        std::is_arithmetic<T>::value && !std::is_same<T, bool>::value && (sizeof(T) > 1)>
+{
+};
+
+template <typename T, bool = std::is_integral<T>::value>
+struct numeric_range
+{
+    static bool contains(uint64_t /*max_positive*/, int64_t /*min_negative*/)
+    {
+        return true;
+    }
+};
+
+template <typename T>
+struct numeric_range<T, true>
+{
+    static bool contains(uint64_t max_positive, int64_t min_negative)
+    {
+        return max_positive <= static_cast<uint64_t>(std::numeric_limits<T>::max())
+            && min_negative >= static_cast<int64_t>(std::numeric_limits<T>::min());
+    }
+};
+
+/*!
+ * Decodes an array of numbers into @p values, reusing their capacity.
+ *
+ * Arrays holding only floating point or only integer numbers, which is the common case
+ * for e.g. sensor frames or price ladders, are copied in a tight loop without converting
+ * each element through msgpack. Mixed arrays, and arrays whose integers are out of range
+ * for T, go through the regular per-element conversion, which also raises the errors.
+ *
+ * @throw msgpack::type_error
+ */
+template <typename T, typename Allocator>
+inline void decode_numeric_array(const msgpack::object& array, std::vector<T, Allocator>& values)
+{
+    static_assert(is_numeric_array_element<T>::value, "numeric array elements must be arithmetic");
+
+    if (array.type != msgpack::type::ARRAY) {
+        throw msgpack::type_error();
+    }
+
+    const std::size_t size = array.via.array.size;
+    const msgpack::object* items = array.via.array.ptr;
+    values.resize(size);
+
+    bool floats = true;
+    bool integers = true;
+    uint64_t max_positive = 0;
+    int64_t min_negative = 0;
+    for (std::size_t i = 0; i < size; ++i) {
+        switch (items[i].type) {
+            case msgpack::type::FLOAT32:
+            case msgpack::type::FLOAT64:
+                integers = false;
+                break;
+            case msgpack::type::POSITIVE_INTEGER:
+                floats = false;
+                max_positive = std::max(max_positive, items[i].via.u64);
+                break;
+            case msgpack::type::NEGATIVE_INTEGER:
+                floats = false;
+                min_negative = std::min(min_negative, items[i].via.i64);
+                break;
+            default:
+                floats = false;
+                integers = false;
+                break;
+        }
+    }
+
+    if (floats && std::is_floating_point<T>::value) {
+        for (std::size_t i = 0; i < size; ++i) {
+            values[i] = static_cast<T>(items[i].via.f64);
+        }
+        return;
+    }
+
+    if (integers && numeric_range<T>::contains(max_positive, min_negative)) {
+        for (std::size_t i = 0; i < size; ++i) {
+            values[i] = items[i].type == msgpack::type::POSITIVE_INTEGER
+                ? static_cast<T>(items[i].via.u64)
+                : static_cast<T>(items[i].via.i64);
+        }
+        return;
+    }
+
+    for (std::size_t i = 0; i < size; ++i) {
+        values[i] = items[i].as<T>();
+    }
+}
+
+/*!
+ * Converts @p object into the existing @p value, used by the argument accessors.
+ * Vectors of numbers take the decode_numeric_array() fast path.
+ */
+template <typename T>
+inline void convert_argument(const msgpack::object& object, T& value)
+{
+    object.convert(value);
+}
+
+template <typename T, typename Allocator>
+inline typename std::enable_if<is_numeric_array_element<T>::value>::type
+convert_argument(const msgpack::object& object, std::vector<T, Allocator>& values)
+{
+    decode_numeric_array(object, values);
+}
+
+template <typename T>
+struct argument_converter
+{
+    static T as(const msgpack::object& object)
+    {
+        return object.as<T>();
+    }
+};
+
+template <typename T, typename Allocator>
+struct argument_converter<std::vector<T, Allocator>>
+{
+    static std::vector<T, Allocator> as(const msgpack::object& object)
+    {
+        std::vector<T, Allocator> values;
+        convert_argument(object, values);
+        return values;
+    }
+};
+
+/*!
+ * Converts @p object to type T, used by the argument accessors.
+ */
+template <typename T>
+inline T argument_as(const msgpack::object& object)
+{
+    return argument_converter<T>::as(object);
+}
+
+/*!
+ * Compile-time index sequence for expanding argument tuples.
+ */
+template <std::size_t... Indices>
+struct argument_indices
+{
+};
+
+template <std::size_t N, std::size_t... Indices>
+struct make_argument_indices : make_argument_indices<N - 1, N - 1, Indices...>
+{
+};
+
+template <std::size_t... Indices>
+struct make_argument_indices<0, Indices...>
+{
+    using type = argument_indices<Indices...>;
+};
+
 } // namespace autobahn
 
+#include "wamp_arguments.ipp"
+
 #endif // AUTOBAHN_WAMP_ARGUMENTS_HPP
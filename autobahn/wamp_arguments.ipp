@@ -0,0 +1,350 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Crossbar.io Technologies GmbH and contributors
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <boost/version.hpp>
+#include <msgpack.hpp>
+#if BOOST_VERSION >= 106100
+#include <msgpack/adaptor/boost/string_view.hpp>
+#endif
+
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace autobahn {
+
+inline wamp_key::wamp_key(const char* key, std::size_t size)
+    : m_data(key)
+    , m_size(size)
+    , m_hash(0)
+    , m_hashed(false)
+{
+}
+
+inline wamp_key::wamp_key(const std::string& key)
+    : m_data(key.data())
+    , m_size(key.size())
+    , m_hash(0)
+    , m_hashed(false)
+{
+}
+
+inline std::string wamp_key::str() const
+{
+    return std::string(m_data, m_size);
+}
+
+inline uint64_t wamp_key::runtime_hash(const char* data, std::size_t size)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (std::size_t i = 0; i < size; ++i) {
+        hash = (hash ^ static_cast<uint8_t>(data[i])) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+struct wamp_map_index::table
+{
+    struct slot
+    {
+        // Upper half of the key hash, compared before the key itself.
+        uint32_t tag;
+
+        // Position of the map entry plus one, zero for an empty slot.
+        uint32_t entry;
+    };
+
+    std::vector<slot> slots;
+    std::size_t mask;
+};
+
+inline wamp_map_index::wamp_map_index()
+    : m_table(nullptr)
+{
+}
+
+inline wamp_map_index::wamp_map_index(wamp_map_index&& other)
+    : m_table(other.m_table.exchange(nullptr))
+{
+}
+
+inline wamp_map_index::~wamp_map_index()
+{
+    delete m_table.load();
+}
+
+inline wamp_map_index& wamp_map_index::operator=(wamp_map_index&& other)
+{
+    if (this == &other) {
+        return *this;
+    }
+
+    delete m_table.exchange(other.m_table.exchange(nullptr));
+
+    return *this;
+}
+
+inline const msgpack::object* wamp_map_index::find(const msgpack::object& map, const wamp_key& key) const
+{
+    if (map.type != msgpack::type::MAP) {
+        throw msgpack::type_error();
+    }
+
+    if (map.via.map.size <= LINEAR_SCAN_LIMIT) {
+        return scan(map, key);
+    }
+
+    table* index = m_table.load(std::memory_order_acquire);
+    if (!index) {
+        // Concurrent look-ups may race to build the table, the first one wins.
+        table* built = build(map);
+        if (m_table.compare_exchange_strong(index, built, std::memory_order_acq_rel)) {
+            index = built;
+        } else {
+            delete built;
+        }
+    }
+
+    const uint64_t hash = key.hash();
+    const uint32_t tag = static_cast<uint32_t>(hash >> 32);
+    for (std::size_t position = hash & index->mask; ; position = (position + 1) & index->mask) {
+        const table::slot& slot = index->slots[position];
+        if (slot.entry == 0) {
+            return nullptr;
+        }
+        if (slot.tag == tag) {
+            const msgpack::object_kv& kv = map.via.map.ptr[slot.entry - 1];
+            if (key.size() == kv.key.via.str.size
+                    && memcmp(key.data(), kv.key.via.str.ptr, key.size()) == 0) {
+                return &kv.val;
+            }
+        }
+    }
+}
+
+inline void wamp_map_index::reset()
+{
+    delete m_table.exchange(nullptr);
+}
+
+inline const msgpack::object* wamp_map_index::scan(const msgpack::object& map, const wamp_key& key)
+{
+    for (std::size_t i = 0; i < map.via.map.size; ++i) {
+        const msgpack::object_kv& kv = map.via.map.ptr[i];
+        if (kv.key.type == msgpack::type::STR && key.size() == kv.key.via.str.size
+                && memcmp(key.data(), kv.key.via.str.ptr, key.size()) == 0)
+        {
+            return &kv.val;
+        }
+    }
+    return nullptr;
+}
+
+inline wamp_map_index::table* wamp_map_index::build(const msgpack::object& map)
+{
+    // Keep the load factor at or below 1/2 so probe sequences stay short.
+    std::size_t capacity = 16;
+    while (capacity < 2 * static_cast<std::size_t>(map.via.map.size)) {
+        capacity <<= 1;
+    }
+
+    table* index = new table();
+    index->slots.resize(capacity, table::slot{0, 0});
+    index->mask = capacity - 1;
+
+    // Entries are inserted in map order, so for duplicate keys the first
+    // entry is found first, just like with a linear scan.
+    for (std::size_t i = 0; i < map.via.map.size; ++i) {
+        const msgpack::object_kv& kv = map.via.map.ptr[i];
+        if (kv.key.type != msgpack::type::STR) {
+            continue;
+        }
+
+        const uint64_t hash = wamp_key::runtime_hash(kv.key.via.str.ptr, kv.key.via.str.size);
+        std::size_t position = hash & index->mask;
+        while (index->slots[position].entry != 0) {
+            position = (position + 1) & index->mask;
+        }
+        index->slots[position].tag = static_cast<uint32_t>(hash >> 32);
+        index->slots[position].entry = static_cast<uint32_t>(i + 1);
+    }
+
+    return index;
+}
+
+} // namespace autobahn
+
+namespace autobahn {
+
+/*!
+ * Element types of spans that are packed as, and can view, msgpack BIN objects.
+ */
+template <typename T>
+struct is_byte_span_element : std::integral_constant<bool,
+        std::is_same<typename std::remove_const<T>::type, uint8_t>::value ||
+        std::is_same<typename std::remove_const<T>::type, char>::value>
+{
+};
+
+} // namespace autobahn
+
+namespace msgpack {
+MSGPACK_API_VERSION_NAMESPACE(MSGPACK_DEFAULT_API_NS) {
+namespace adaptor {
+
+// Byte spans view the BIN (or STR) payload in place, so converting to them
+// never copies. The view is only valid as long as the zone holding the object.
+template <typename Byte>
+struct convert<autobahn::span<Byte>, typename std::enable_if<
+        autobahn::is_byte_span_element<Byte>::value && std::is_const<Byte>::value>::type>
+{
+    msgpack::object const& operator()(
+            msgpack::object const& object,
+            autobahn::span<Byte>& bytes) const
+    {
+        switch (object.type) {
+            case msgpack::type::BIN:
+                bytes = autobahn::span<Byte>(
+                        reinterpret_cast<Byte*>(object.via.bin.ptr), object.via.bin.size);
+                break;
+            case msgpack::type::STR:
+                bytes = autobahn::span<Byte>(
+                        reinterpret_cast<Byte*>(object.via.str.ptr), object.via.str.size);
+                break;
+            default:
+                throw msgpack::type_error();
+        }
+
+        return object;
+    }
+};
+
+template <typename Byte>
+struct pack<autobahn::span<Byte>, typename std::enable_if<
+        autobahn::is_byte_span_element<Byte>::value>::type>
+{
+    template <typename Stream>
+    msgpack::packer<Stream>& operator()(
+            msgpack::packer<Stream>& packer,
+            autobahn::span<Byte> const& bytes) const
+    {
+        if (bytes.size() > 0xffffffffU) {
+            throw std::length_error("binary argument too large");
+        }
+
+        const uint32_t size = static_cast<uint32_t>(bytes.size());
+        packer.pack_bin(size);
+        packer.pack_bin_body(reinterpret_cast<const char*>(bytes.data()), size);
+
+        return packer;
+    }
+};
+
+template <typename Byte>
+struct object_with_zone<autobahn::span<Byte>, typename std::enable_if<
+        autobahn::is_byte_span_element<Byte>::value>::type>
+{
+    void operator()(
+            msgpack::object::with_zone& object,
+            autobahn::span<Byte> const& bytes) const
+    {
+        if (bytes.size() > 0xffffffffU) {
+            throw std::length_error("binary argument too large");
+        }
+
+        const uint32_t size = static_cast<uint32_t>(bytes.size());
+        char* ptr = nullptr;
+        if (size > 0) {
+            ptr = static_cast<char*>(object.zone.allocate_no_align(size));
+            memcpy(ptr, bytes.data(), size);
+        }
+
+        object.type = msgpack::type::BIN;
+        object.via.bin.ptr = ptr;
+        object.via.bin.size = size;
+    }
+};
+
+// Spans of numbers are packed as msgpack arrays, which allows publishing or
+// calling with e.g. a span<const double> over an existing buffer.
+template <typename T>
+struct pack<autobahn::span<T>, typename std::enable_if<
+        autobahn::is_numeric_array_element<typename std::remove_const<T>::type>::value>::type>
+{
+    template <typename Stream>
+    msgpack::packer<Stream>& operator()(
+            msgpack::packer<Stream>& packer,
+            autobahn::span<T> const& values) const
+    {
+        if (values.size() > 0xffffffffU) {
+            throw std::length_error("array argument too large");
+        }
+
+        packer.pack_array(static_cast<uint32_t>(values.size()));
+        for (const auto& value : values) {
+            packer.pack(value);
+        }
+
+        return packer;
+    }
+};
+
+template <typename T>
+struct object_with_zone<autobahn::span<T>, typename std::enable_if<
+        autobahn::is_numeric_array_element<typename std::remove_const<T>::type>::value>::type>
+{
+    void operator()(
+            msgpack::object::with_zone& object,
+            autobahn::span<T> const& values) const
+    {
+        if (values.size() > 0xffffffffU) {
+            throw std::length_error("array argument too large");
+        }
+
+        const uint32_t size = static_cast<uint32_t>(values.size());
+        msgpack::object* items = nullptr;
+        if (size > 0) {
+            items = static_cast<msgpack::object*>(
+                    object.zone.allocate_align(sizeof(msgpack::object) * size));
+            for (uint32_t i = 0; i < size; ++i) {
+                items[i] = msgpack::object(values[i]);
+            }
+        }
+
+        object.type = msgpack::type::ARRAY;
+        object.via.array.ptr = items;
+        object.via.array.size = size;
+    }
+};
+
+} // namespace adaptor
+} // MSGPACK_API_VERSION_NAMESPACE(MSGPACK_DEFAULT_API_NS)
+} // namespace msgpack
@@ -0,0 +1,118 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Crossbar.io Technologies GmbH and contributors
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef AUTOBAHN_WAMP_BATCHER_HPP
+#define AUTOBAHN_WAMP_BATCHER_HPP
+
+#include "boost_config.hpp"
+
+#include <boost/asio/io_service.hpp>
+#include <boost/asio/io_service_strand.hpp>
+#include <boost/asio/steady_timer.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace autobahn {
+
+/*!
+ * How invocations or events are collected into batches, see
+ * wamp_session::provide_batch() and wamp_session::subscribe_batch().
+ */
+class wamp_batch_options
+{
+public:
+    /// Batches of up to 64 items, waiting at most a millisecond.
+    wamp_batch_options();
+
+    wamp_batch_options(std::size_t max_batch_size, const std::chrono::microseconds& max_wait);
+
+    /// A batch is handed over as soon as it holds this many items. Zero for no limit.
+    std::size_t max_batch_size() const;
+    void set_max_batch_size(std::size_t max_batch_size);
+
+    /*!
+     * How long the first item of a batch may wait for others. Zero hands
+     * over whatever arrived together, e.g. in one transport read.
+     */
+    const std::chrono::microseconds& max_wait() const;
+    void set_max_wait(const std::chrono::microseconds& max_wait);
+
+private:
+    std::size_t m_max_batch_size;
+    std::chrono::microseconds m_max_wait;
+};
+
+/*!
+ * Collects items on the session strand and hands them over in batches.
+ * Only used internally by wamp_session.
+ */
+template <typename Item>
+class wamp_batcher :
+        public std::enable_shared_from_this<wamp_batcher<Item>>
+{
+public:
+    using flush_fn = std::function<void(std::vector<Item>&&)>;
+
+    wamp_batcher(
+            boost::asio::io_service& io_service,
+            const boost::asio::io_service::strand& strand,
+            const wamp_batch_options& options,
+            flush_fn&& flush);
+
+    /// Adds an item to the batch. Must be called on the strand.
+    void add(const Item& item);
+
+private:
+    void arm();
+    void flush(uint64_t batch);
+
+    boost::asio::io_service::strand m_strand;
+    boost::asio::steady_timer m_timer;
+    wamp_batch_options m_options;
+    flush_fn m_flush;
+
+    std::vector<Item> m_items;
+
+    // Numbers the batches, so a flush scheduled for a batch handed over
+    // already leaves the next one alone.
+    uint64_t m_batch;
+};
+
+} // namespace autobahn
+
+#include "wamp_batcher.ipp"
+
+#endif // AUTOBAHN_WAMP_BATCHER_HPP
@@ -0,0 +1,141 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Crossbar.io Technologies GmbH and contributors
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include <utility>
+
+namespace autobahn {
+
+inline wamp_batch_options::wamp_batch_options()
+    : m_max_batch_size(64)
+    , m_max_wait(1000)
+{
+}
+
+inline wamp_batch_options::wamp_batch_options(
+        std::size_t max_batch_size, const std::chrono::microseconds& max_wait)
+    : m_max_batch_size(max_batch_size)
+    , m_max_wait(max_wait)
+{
+}
+
+inline std::size_t wamp_batch_options::max_batch_size() const
+{
+    return m_max_batch_size;
+}
+
+inline void wamp_batch_options::set_max_batch_size(std::size_t max_batch_size)
+{
+    m_max_batch_size = max_batch_size;
+}
+
+inline const std::chrono::microseconds& wamp_batch_options::max_wait() const
+{
+    return m_max_wait;
+}
+
+inline void wamp_batch_options::set_max_wait(const std::chrono::microseconds& max_wait)
+{
+    m_max_wait = max_wait;
+}
+
+template <typename Item>
+inline wamp_batcher<Item>::wamp_batcher(
+        boost::asio::io_service& io_service,
+        const boost::asio::io_service::strand& strand,
+        const wamp_batch_options& options,
+        flush_fn&& flush)
+    : m_strand(strand)
+    , m_timer(io_service)
+    , m_options(options)
+    , m_flush(std::move(flush))
+    , m_items()
+    , m_batch(0)
+{
+}
+
+template <typename Item>
+inline void wamp_batcher<Item>::add(const Item& item)
+{
+    m_items.push_back(item);
+
+    if (m_options.max_batch_size() > 0 && m_items.size() >= m_options.max_batch_size()) {
+        flush(m_batch);
+    } else if (m_items.size() == 1) {
+        arm();
+    }
+}
+
+template <typename Item>
+inline void wamp_batcher<Item>::arm()
+{
+    std::weak_ptr<wamp_batcher<Item>> weak_self = this->shared_from_this();
+    const uint64_t batch = m_batch;
+
+    // Without a wait, the batch takes what arrives before the strand gets
+    // to run the flush, e.g. the rest of a transport read.
+    if (m_options.max_wait().count() == 0) {
+        m_strand.post([weak_self, batch]() {
+            auto shared_self = weak_self.lock();
+            if (shared_self) {
+                shared_self->flush(batch);
+            }
+        });
+        return;
+    }
+
+    m_timer.expires_from_now(m_options.max_wait());
+    m_timer.async_wait(m_strand.wrap([weak_self, batch](const boost::system::error_code& error) {
+        auto shared_self = weak_self.lock();
+        if (!shared_self || error == boost::asio::error::operation_aborted) {
+            return;
+        }
+        shared_self->flush(batch);
+    }));
+}
+
+template <typename Item>
+inline void wamp_batcher<Item>::flush(uint64_t batch)
+{
+    if (batch != m_batch || m_items.empty()) {
+        return;
+    }
+
+    ++m_batch;
+    m_timer.cancel();
+
+    std::vector<Item> items;
+    items.swap(m_items);
+    m_items.reserve(items.size());
+
+    m_flush(std::move(items));
+}
+
+} // namespace autobahn
@@ -31,8 +31,15 @@
 #ifndef AUTOBAHN_WAMP_CALL_HPP
 #define AUTOBAHN_WAMP_CALL_HPP
 
+#include "wamp_call_handle.hpp"
+#include "wamp_call_options.hpp"
 #include "wamp_call_result.hpp"
-#include "boost_config.hpp"
+#include "wamp_completion.hpp"
+#include "wamp_timer_wheel.hpp"
+
+#include <chrono>
+#include <exception>
+#include <memory>
 
 namespace autobahn {
 
@@ -40,13 +47,33 @@ namespace autobahn {
 class wamp_call
 {
 public:
+    using completion_type = wamp_completion<void(std::exception_ptr, wamp_call_result)>;
+
     wamp_call();
+    wamp_call(
+            const std::chrono::milliseconds& timeout,
+            const wamp_call_handle& handle,
+            const wamp_progress_handler& progress_handler,
+            completion_type&& completion);
+
+    const std::chrono::milliseconds& timeout() const;
+    const wamp_call_handle& handle() const;
+
+    /// Shared, so that it stays valid while the call is canceled from within the handler.
+    const std::shared_ptr<const wamp_progress_handler>& progress_handler() const;
+
+    /// The deadline of the call in the session's timer wheel, if it has a timeout.
+    wamp_timer_wheel::handle& deadline();
 
-    boost::promise<wamp_call_result>& result();
     void set_result(wamp_call_result&& value);
+    void set_exception(std::exception_ptr exception);
 
 private:
-    boost::promise<wamp_call_result> m_result;
+    std::chrono::milliseconds m_timeout;
+    wamp_call_handle m_handle;
+    std::shared_ptr<const wamp_progress_handler> m_progress_handler;
+    wamp_timer_wheel::handle m_deadline;
+    completion_type m_completion;
 };
 
 } // namespace autobahn
@@ -31,18 +31,56 @@
 namespace autobahn {
 
 inline wamp_call::wamp_call()
-    : m_result()
+    : m_timeout()
+    , m_handle(nullptr)
+    , m_progress_handler()
+    , m_deadline()
+    , m_completion()
 {
 }
 
-inline boost::promise<wamp_call_result>& wamp_call::result()
+inline wamp_call::wamp_call(
+        const std::chrono::milliseconds& timeout,
+        const wamp_call_handle& handle,
+        const wamp_progress_handler& progress_handler,
+        completion_type&& completion)
+    : m_timeout(timeout)
+    , m_handle(handle)
+    , m_progress_handler(progress_handler
+            ? std::make_shared<const wamp_progress_handler>(progress_handler) : nullptr)
+    , m_deadline()
+    , m_completion(std::move(completion))
 {
-    return m_result;
+}
+
+inline const std::chrono::milliseconds& wamp_call::timeout() const
+{
+    return m_timeout;
+}
+
+inline const wamp_call_handle& wamp_call::handle() const
+{
+    return m_handle;
+}
+
+inline const std::shared_ptr<const wamp_progress_handler>& wamp_call::progress_handler() const
+{
+    return m_progress_handler;
+}
+
+inline wamp_timer_wheel::handle& wamp_call::deadline()
+{
+    return m_deadline;
 }
 
 inline void wamp_call::set_result(wamp_call_result&& value)
 {
-    m_result.set_value(std::move(value));
+    m_completion.complete(nullptr, std::move(value));
+}
+
+inline void wamp_call::set_exception(std::exception_ptr exception)
+{
+    m_completion.fail(std::move(exception));
 }
 
 } // namespace autobahn
@@ -0,0 +1,107 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Crossbar.io Technologies GmbH and contributors
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef AUTOBAHN_WAMP_CALL_HANDLE_HPP
+#define AUTOBAHN_WAMP_CALL_HANDLE_HPP
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace autobahn {
+
+/// How the dealer treats a canceled call, see wamp_call_handle::cancel().
+enum class wamp_cancel_mode
+{
+    /// Stop waiting for the result, the callee is not interrupted.
+    skip,
+    /// Interrupt the callee and wait for it to acknowledge.
+    kill,
+    /// Interrupt the callee without waiting for it.
+    killnowait
+};
+
+/// The name of the cancel mode as used in CANCEL.Options.mode.
+const char* cancel_mode_name(wamp_cancel_mode mode);
+
+/// The cancel mode with the given name, kill for unknown names.
+wamp_cancel_mode cancel_mode_from_name(const std::string& name);
+
+/*!
+ * Handle to cancel an outstanding call. Pass it in the wamp_call_options of
+ * the call to be able to cancel it later, possibly from another thread.
+ *
+ * Copies of a handle refer to the same call.
+ */
+class wamp_call_handle
+{
+public:
+    wamp_call_handle();
+
+    /// Constructs an empty handle, which is not bound to any call.
+    wamp_call_handle(std::nullptr_t);
+
+    explicit operator bool() const;
+
+    /*!
+     * Cancels the call. Its future or completion handler fails with
+     * autobahn::canceled_error right away and a CANCEL with the given mode is
+     * sent if the dealer supports call canceling. Does nothing once the call
+     * has completed. A handle canceled before its call was made cancels the
+     * call as soon as it is made.
+     */
+    void cancel(wamp_cancel_mode mode = wamp_cancel_mode::kill) const;
+
+    //
+    // functions only called internally by wamp_session
+
+    using cancel_fn = std::function<void(wamp_cancel_mode)>;
+    void bind(cancel_fn&& cancel) const;
+
+private:
+    struct state
+    {
+        std::mutex mutex;
+        cancel_fn cancel;
+        bool canceled;
+        wamp_cancel_mode mode;
+    };
+
+    std::shared_ptr<state> m_state;
+};
+
+} // namespace autobahn
+
+#include "wamp_call_handle.ipp"
+
+#endif // AUTOBAHN_WAMP_CALL_HANDLE_HPP
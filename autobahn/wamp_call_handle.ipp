@@ -0,0 +1,119 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Crossbar.io Technologies GmbH and contributors
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include <utility>
+
+namespace autobahn {
+
+inline const char* cancel_mode_name(wamp_cancel_mode mode)
+{
+    switch (mode) {
+        case wamp_cancel_mode::skip:
+            return "skip";
+        case wamp_cancel_mode::killnowait:
+            return "killnowait";
+        case wamp_cancel_mode::kill:
+        default:
+            return "kill";
+    }
+}
+
+inline wamp_cancel_mode cancel_mode_from_name(const std::string& name)
+{
+    if (name == "skip") {
+        return wamp_cancel_mode::skip;
+    }
+    if (name == "killnowait") {
+        return wamp_cancel_mode::killnowait;
+    }
+    return wamp_cancel_mode::kill;
+}
+
+inline wamp_call_handle::wamp_call_handle()
+    : m_state(std::make_shared<state>())
+{
+    m_state->canceled = false;
+    m_state->mode = wamp_cancel_mode::kill;
+}
+
+inline wamp_call_handle::wamp_call_handle(std::nullptr_t)
+    : m_state()
+{
+}
+
+inline wamp_call_handle::operator bool() const
+{
+    return m_state != nullptr;
+}
+
+inline void wamp_call_handle::cancel(wamp_cancel_mode mode) const
+{
+    if (!m_state) {
+        return;
+    }
+
+    cancel_fn cancel;
+    {
+        std::lock_guard<std::mutex> lock(m_state->mutex);
+        if (m_state->canceled) {
+            return;
+        }
+        m_state->canceled = true;
+        m_state->mode = mode;
+        cancel = m_state->cancel;
+    }
+
+    if (cancel) {
+        cancel(mode);
+    }
+}
+
+inline void wamp_call_handle::bind(cancel_fn&& cancel) const
+{
+    if (!m_state) {
+        return;
+    }
+
+    bool canceled = false;
+    wamp_cancel_mode mode = wamp_cancel_mode::kill;
+    {
+        std::lock_guard<std::mutex> lock(m_state->mutex);
+        m_state->cancel = cancel;
+        canceled = m_state->canceled;
+        mode = m_state->mode;
+    }
+
+    if (canceled) {
+        cancel(mode);
+    }
+}
+
+} // namespace autobahn
@@ -31,10 +31,17 @@
 #ifndef AUTOBAHN_WAMP_CALL_OPTIONS_HPP
 #define AUTOBAHN_WAMP_CALL_OPTIONS_HPP
 
+#include "wamp_call_handle.hpp"
+#include "wamp_call_result.hpp"
+
 #include <chrono>
+#include <functional>
 
 namespace autobahn {
 
+/// Handler receiving the progressive results of a call.
+using wamp_progress_handler = std::function<void(wamp_call_result&&)>;
+
 class wamp_call_options
 {
 public:
@@ -47,10 +54,34 @@ public:
 
     const std::chrono::milliseconds& timeout() const;
 
+    /*!
+     * Sets the call timeout, which is passed to the router and also enforced by
+     * the session: if no result has arrived when it elapses, the call fails with
+     * autobahn::timeout_error and is no longer tracked.
+     */
     void set_timeout(const std::chrono::milliseconds& timeout);
 
+    const wamp_call_handle& handle() const;
+
+    /*!
+     * Sets the handle through which the call can be canceled.
+     */
+    void set_handle(const wamp_call_handle& handle);
+
+    const wamp_progress_handler& progress_handler() const;
+
+    /*!
+     * Sets a handler for progressive results and asks the callee for them
+     * (receive_progress). The handler runs on the io_service thread for each
+     * progressive result as it arrives, the final result completes the call
+     * as usual. This way large results can be consumed piece by piece.
+     */
+    void set_progress_handler(const wamp_progress_handler& handler);
+
 private:
     std::chrono::milliseconds m_timeout;
+    wamp_call_handle m_handle;
+    wamp_progress_handler m_progress_handler;
 };
 
 } // namespace autobahn
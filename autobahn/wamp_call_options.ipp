@@ -36,6 +36,8 @@ namespace autobahn {
 
 inline wamp_call_options::wamp_call_options()
     : m_timeout()
+    , m_handle(nullptr)
+    , m_progress_handler()
 {
 }
 
@@ -49,6 +51,26 @@ inline void wamp_call_options::set_timeout(const std::chrono::milliseconds& time
     m_timeout = timeout;
 }
 
+inline const wamp_call_handle& wamp_call_options::handle() const
+{
+    return m_handle;
+}
+
+inline void wamp_call_options::set_handle(const wamp_call_handle& handle)
+{
+    m_handle = handle;
+}
+
+inline const wamp_progress_handler& wamp_call_options::progress_handler() const
+{
+    return m_progress_handler;
+}
+
+inline void wamp_call_options::set_progress_handler(const wamp_progress_handler& handler)
+{
+    m_progress_handler = handler;
+}
+
 } // namespace autobahn
 
 namespace msgpack {
@@ -82,13 +104,18 @@ struct pack<autobahn::wamp_call_options>
             msgpack::packer<Stream>& packer,
             autobahn::wamp_call_options const& options) const
     {
-        std::unordered_map<std::string, unsigned> options_map;
         const auto& timeout = options.timeout();
+        const bool receive_progress = static_cast<bool>(options.progress_handler());
+
+        packer.pack_map((timeout.count() > 0 ? 1 : 0) + (receive_progress ? 1 : 0));
         if (timeout.count() > 0) {
-            options_map["timeout"] = timeout.count();
+            packer.pack(std::string("timeout"));
+            packer.pack(static_cast<unsigned>(timeout.count()));
+        }
+        if (receive_progress) {
+            packer.pack(std::string("receive_progress"));
+            packer.pack(true);
         }
-
-        packer.pack(options_map);
 
         return packer;
     }
@@ -107,6 +134,9 @@ struct object_with_zone<autobahn::wamp_call_options>
         if (timeout.count() != 0) {
             options_map["timeout"] = msgpack::object(timeout.count());
         }
+        if (options.progress_handler()) {
+            options_map["receive_progress"] = msgpack::object(true);
+        }
 
         object << options_map;
     }
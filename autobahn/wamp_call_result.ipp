@@ -53,6 +53,7 @@ inline wamp_call_result::wamp_call_result(wamp_call_result&& other)
     : m_zone(std::move(other.m_zone))
     , m_arguments(other.m_arguments)
     , m_kw_arguments(other.m_kw_arguments)
+    , m_kw_arguments_index(std::move(other.m_kw_arguments_index))
 {
     other.m_arguments = EMPTY_ARGUMENTS;
     other.m_kw_arguments = EMPTY_KW_ARGUMENTS;
@@ -66,6 +67,7 @@ inline wamp_call_result& wamp_call_result::operator=(wamp_call_result&& other)
 
     m_arguments = other.m_arguments;
     m_kw_arguments = other.m_kw_arguments;
+    m_kw_arguments_index = std::move(other.m_kw_arguments_index);
     m_zone = std::move(other.m_zone);
 
     other.m_arguments = EMPTY_ARGUMENTS;
@@ -90,7 +92,16 @@ inline T wamp_call_result::argument(std::size_t index) const
     if (m_arguments.type != msgpack::type::ARRAY || m_arguments.via.array.size <= index) {
         throw std::out_of_range("no argument at index " + boost::lexical_cast<std::string>(index));
     }
-    return m_arguments.via.array.ptr[index].as<T>();
+    return argument_as<T>(m_arguments.via.array.ptr[index]);
+}
+
+template <typename T>
+inline void wamp_call_result::get_argument(std::size_t index, T& value) const
+{
+    if (m_arguments.type != msgpack::type::ARRAY || m_arguments.via.array.size <= index) {
+        throw std::out_of_range("no argument at index " + boost::lexical_cast<std::string>(index));
+    }
+    convert_argument(m_arguments.via.array.ptr[index], value);
 }
 
 template <typename List>
@@ -115,71 +126,42 @@ inline void wamp_call_result::get_each_argument(T&... args) const
 template <typename T>
 inline T wamp_call_result::kw_argument(const std::string& key) const
 {
-    if (m_kw_arguments.type != msgpack::type::MAP) {
-        throw msgpack::type_error();
-    }
-    for (std::size_t i = 0; i < m_kw_arguments.via.map.size; ++i) {
-        const msgpack::object_kv& kv = m_kw_arguments.via.map.ptr[i];
-        if (kv.key.type == msgpack::type::STR && key.size() == kv.key.via.str.size
-                && key.compare(0, key.size(), kv.key.via.str.ptr, kv.key.via.str.size) == 0)
-        {
-            return kv.val.as<T>();
-        }
-    }
-    throw std::out_of_range(key + " keyword argument doesn't exist");
+    return kw_argument<T>(wamp_key(key));
 }
 
 template <typename T>
 inline T wamp_call_result::kw_argument(const char* key) const
 {
-    if (m_kw_arguments.type != msgpack::type::MAP) {
-        throw msgpack::type_error();
-    }
-    std::size_t key_size = strlen(key);
-    for (std::size_t i = 0; i < m_kw_arguments.via.map.size; ++i) {
-        const msgpack::object_kv& kv = m_kw_arguments.via.map.ptr[i];
-        if (kv.key.type == msgpack::type::STR && key_size == kv.key.via.str.size
-                && memcmp(key, kv.key.via.str.ptr, key_size) == 0)
-        {
-            return kv.val.as<T>();
-        }
+    return kw_argument<T>(wamp_key(key, strlen(key)));
+}
+
+template <typename T>
+inline T wamp_call_result::kw_argument(const wamp_key& key) const
+{
+    const msgpack::object* value = m_kw_arguments_index.find(m_kw_arguments, key);
+    if (!value) {
+        throw std::out_of_range(key.str() + " keyword argument doesn't exist");
     }
-    throw std::out_of_range(std::string(key) + " keyword argument doesn't exist");
+    return argument_as<T>(*value);
 }
 
 template <typename T>
 inline T wamp_call_result::kw_argument_or(const std::string& key, const T& fallback) const
 {
-    if (m_kw_arguments.type != msgpack::type::MAP) {
-        throw msgpack::type_error();
-    }
-    for (std::size_t i = 0; i < m_kw_arguments.via.map.size; ++i) {
-        const msgpack::object_kv& kv = m_kw_arguments.via.map.ptr[i];
-        if (kv.key.type == msgpack::type::STR && key.size() == kv.key.via.str.size
-                && key.compare(0, key.size(), kv.key.via.str.ptr, kv.key.via.str.size) == 0)
-        {
-            return kv.val.as<T>();
-        }
-    }
-    return fallback;
+    return kw_argument_or<T>(wamp_key(key), fallback);
 }
 
 template <typename T>
 inline T wamp_call_result::kw_argument_or(const char* key, const T& fallback) const
 {
-    if (m_kw_arguments.type != msgpack::type::MAP) {
-        throw msgpack::type_error();
-    }
-    std::size_t key_size = strlen(key);
-    for (std::size_t i = 0; i < m_kw_arguments.via.map.size; ++i) {
-        const msgpack::object_kv& kv = m_kw_arguments.via.map.ptr[i];
-        if (kv.key.type == msgpack::type::STR && key_size == kv.key.via.str.size
-                && memcmp(key, kv.key.via.str.ptr, key_size) == 0)
-        {
-            return kv.val.as<T>();
-        }
-    }
-    throw fallback;
+    return kw_argument_or<T>(wamp_key(key, strlen(key)), fallback);
+}
+
+template <typename T>
+inline T wamp_call_result::kw_argument_or(const wamp_key& key, const T& fallback) const
+{
+    const msgpack::object* value = m_kw_arguments_index.find(m_kw_arguments, key);
+    return value ? argument_as<T>(*value) : fallback;
 }
 
 template <typename Map>
@@ -202,6 +184,7 @@ inline void wamp_call_result::set_arguments(const msgpack::object& arguments)
 inline void wamp_call_result::set_kw_arguments(const msgpack::object& kw_arguments)
 {
     m_kw_arguments = kw_arguments;
+    m_kw_arguments_index.reset();
 }
 
 } // namespace autobahn
@@ -0,0 +1,169 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Crossbar.io Technologies GmbH and contributors
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef AUTOBAHN_WAMP_COMPLETION_HPP
+#define AUTOBAHN_WAMP_COMPLETION_HPP
+
+#include "boost_config.hpp"
+#include "exceptions.hpp"
+#include "wamp_arguments.hpp"
+
+#include <boost/asio/associated_executor.hpp>
+#include <boost/asio/post.hpp>
+
+#include <cstddef>
+#include <exception>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace autobahn {
+
+template <typename Signature>
+class wamp_completion;
+
+/*!
+ * Type erased completion handler of an asynchronous session operation, with
+ * the signature void(std::exception_ptr, Args...).
+ *
+ * Handlers that are small enough, such as a lambda capturing a few pointers or
+ * a wamp_promise_handler, are stored inline so that tracking the operation in a
+ * pending request record does not allocate. The handler is posted to its
+ * associated executor, which defaults to the executor of the session's io_service,
+ * so it never runs inside the session strand. A completion can only be completed
+ * once and is empty afterwards.
+ */
+template <typename... Args>
+class wamp_completion<void(std::exception_ptr, Args...)>
+{
+public:
+    wamp_completion();
+
+    template <typename Handler, typename Executor>
+    wamp_completion(Handler&& handler, const Executor& io_executor);
+
+    wamp_completion(wamp_completion&& other);
+    wamp_completion& operator=(wamp_completion&& other);
+
+    wamp_completion(const wamp_completion&) = delete;
+    wamp_completion& operator=(const wamp_completion&) = delete;
+
+    ~wamp_completion();
+
+    explicit operator bool() const;
+
+    /*!
+     * Invokes the handler with the given exception, which is null on success,
+     * and result values.
+     */
+    void complete(std::exception_ptr exception, Args... args);
+
+    /*!
+     * Invokes the handler with the given exception and default constructed results.
+     */
+    void fail(std::exception_ptr exception);
+
+private:
+    typedef typename std::aligned_storage<
+            6 * sizeof(void*), alignof(std::max_align_t)>::type storage_type;
+
+    struct operations
+    {
+        void (*move)(storage_type& from, storage_type& to);
+        void (*destroy)(storage_type& storage);
+        void (*complete)(storage_type& storage, std::exception_ptr exception, Args&&... args);
+    };
+
+    template <typename Handler, typename Executor>
+    struct target;
+
+    template <typename Target>
+    struct inline_operations;
+
+    template <typename Target>
+    struct heap_operations;
+
+    template <typename Target, bool = (sizeof(Target) <= sizeof(storage_type)
+            && std::is_nothrow_move_constructible<Target>::value)>
+    struct select_operations;
+
+    const operations* m_operations;
+    storage_type m_storage;
+};
+
+/*!
+ * Whether a completion handler runs no application code and can therefore be
+ * invoked inline by the session rather than posted to its executor.
+ */
+template <typename Handler>
+struct wamp_completes_inline : std::false_type
+{
+};
+
+/*!
+ * Completion handler fulfilling a boost::promise, which implements the
+ * boost::future based session operations on top of the asynchronous ones.
+ */
+template <typename T>
+class wamp_promise_handler
+{
+public:
+    explicit wamp_promise_handler(boost::promise<T>&& promise);
+
+    void operator()(std::exception_ptr exception, T value);
+
+private:
+    boost::promise<T> m_promise;
+};
+
+template <>
+class wamp_promise_handler<void>
+{
+public:
+    explicit wamp_promise_handler(boost::promise<void>&& promise);
+
+    void operator()(std::exception_ptr exception);
+
+private:
+    boost::promise<void> m_promise;
+};
+
+/// Fulfilling a promise only wakes up its waiters.
+template <typename T>
+struct wamp_completes_inline<wamp_promise_handler<T>> : std::true_type
+{
+};
+
+} // namespace autobahn
+
+#include "wamp_completion.ipp"
+
+#endif // AUTOBAHN_WAMP_COMPLETION_HPP
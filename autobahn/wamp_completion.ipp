@@ -0,0 +1,338 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Crossbar.io Technologies GmbH and contributors
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include <new>
+
+namespace autobahn {
+
+template <typename Handler, typename... Args>
+class wamp_completion_binder
+{
+public:
+    wamp_completion_binder(Handler&& handler, std::exception_ptr&& exception, Args&&... args)
+        : m_handler(std::move(handler))
+        , m_exception(std::move(exception))
+        , m_arguments(std::forward<Args>(args)...)
+    {
+    }
+
+    void operator()()
+    {
+        invoke(typename make_argument_indices<sizeof...(Args)>::type());
+    }
+
+private:
+    template <std::size_t... Indices>
+    void invoke(argument_indices<Indices...>)
+    {
+        m_handler(std::move(m_exception), std::get<Indices>(std::move(m_arguments))...);
+    }
+
+    Handler m_handler;
+    std::exception_ptr m_exception;
+    std::tuple<typename std::decay<Args>::type...> m_arguments;
+};
+
+template <typename... Args>
+template <typename Handler, typename Executor>
+struct wamp_completion<void(std::exception_ptr, Args...)>::target
+{
+    target(Handler&& handler, const Executor& executor)
+        : m_handler(std::move(handler))
+        , m_executor(executor)
+    {
+    }
+
+    static void invoke(target&& self, std::exception_ptr&& exception, Args&&... args)
+    {
+        invoke(std::move(self), wamp_completes_inline<Handler>(), std::move(exception), std::forward<Args>(args)...);
+    }
+
+    static void invoke(target&& self, std::true_type, std::exception_ptr&& exception, Args&&... args)
+    {
+        wamp_completion_binder<Handler, Args...>(
+                std::move(self.m_handler), std::move(exception), std::forward<Args>(args)...)();
+    }
+
+    // Posted rather than dispatched: dispatching to an executor of the
+    // session's io_service would run application code inside the session
+    // strand, holding up every other operation of the session.
+    static void invoke(target&& self, std::false_type, std::exception_ptr&& exception, Args&&... args)
+    {
+        boost::asio::post(self.m_executor,
+                wamp_completion_binder<Handler, Args...>(
+                        std::move(self.m_handler), std::move(exception), std::forward<Args>(args)...));
+    }
+
+    Handler m_handler;
+    Executor m_executor;
+};
+
+template <typename... Args>
+template <typename Target>
+struct wamp_completion<void(std::exception_ptr, Args...)>::inline_operations
+{
+    static void move(storage_type& from, storage_type& to)
+    {
+        Target& source = *reinterpret_cast<Target*>(&from);
+        new (&to) Target(std::move(source));
+        source.~Target();
+    }
+
+    static void destroy(storage_type& storage)
+    {
+        reinterpret_cast<Target*>(&storage)->~Target();
+    }
+
+    static void complete(storage_type& storage, std::exception_ptr exception, Args&&... args)
+    {
+        // Move the handler out of the storage before invoking it, so that the
+        // operation is released before the upcall.
+        Target& stored = *reinterpret_cast<Target*>(&storage);
+        Target local(std::move(stored));
+        stored.~Target();
+        Target::invoke(std::move(local), std::move(exception), std::forward<Args>(args)...);
+    }
+
+    static const operations table;
+};
+
+template <typename... Args>
+template <typename Target>
+const typename wamp_completion<void(std::exception_ptr, Args...)>::operations
+wamp_completion<void(std::exception_ptr, Args...)>::inline_operations<Target>::table = {
+    &inline_operations::move,
+    &inline_operations::destroy,
+    &inline_operations::complete
+};
+
+template <typename... Args>
+template <typename Target>
+struct wamp_completion<void(std::exception_ptr, Args...)>::heap_operations
+{
+    static void move(storage_type& from, storage_type& to)
+    {
+        new (&to) Target*(*reinterpret_cast<Target**>(&from));
+    }
+
+    static void destroy(storage_type& storage)
+    {
+        delete *reinterpret_cast<Target**>(&storage);
+    }
+
+    static void complete(storage_type& storage, std::exception_ptr exception, Args&&... args)
+    {
+        Target* stored = *reinterpret_cast<Target**>(&storage);
+        Target local(std::move(*stored));
+        delete stored;
+        Target::invoke(std::move(local), std::move(exception), std::forward<Args>(args)...);
+    }
+
+    static const operations table;
+};
+
+template <typename... Args>
+template <typename Target>
+const typename wamp_completion<void(std::exception_ptr, Args...)>::operations
+wamp_completion<void(std::exception_ptr, Args...)>::heap_operations<Target>::table = {
+    &heap_operations::move,
+    &heap_operations::destroy,
+    &heap_operations::complete
+};
+
+template <typename... Args>
+template <typename Target>
+struct wamp_completion<void(std::exception_ptr, Args...)>::select_operations<Target, true>
+{
+    template <typename... TargetArgs>
+    static const operations* construct(storage_type& storage, TargetArgs&&... args)
+    {
+        new (&storage) Target(std::forward<TargetArgs>(args)...);
+        return &inline_operations<Target>::table;
+    }
+};
+
+template <typename... Args>
+template <typename Target>
+struct wamp_completion<void(std::exception_ptr, Args...)>::select_operations<Target, false>
+{
+    template <typename... TargetArgs>
+    static const operations* construct(storage_type& storage, TargetArgs&&... args)
+    {
+        new (&storage) Target*(new Target(std::forward<TargetArgs>(args)...));
+        return &heap_operations<Target>::table;
+    }
+};
+
+template <typename... Args>
+inline wamp_completion<void(std::exception_ptr, Args...)>::wamp_completion()
+    : m_operations(nullptr)
+    , m_storage()
+{
+}
+
+template <typename... Args>
+template <typename Handler, typename Executor>
+inline wamp_completion<void(std::exception_ptr, Args...)>::wamp_completion(
+        Handler&& handler, const Executor& io_executor)
+    : m_operations(nullptr)
+    , m_storage()
+{
+    typedef typename std::decay<Handler>::type handler_type;
+    typedef typename boost::asio::associated_executor<handler_type, Executor>::type executor_type;
+    typedef target<handler_type, executor_type> target_type;
+
+    handler_type local(std::forward<Handler>(handler));
+    const executor_type executor = boost::asio::get_associated_executor(local, io_executor);
+    m_operations = select_operations<target_type>::construct(m_storage, std::move(local), executor);
+}
+
+template <typename... Args>
+inline wamp_completion<void(std::exception_ptr, Args...)>::wamp_completion(wamp_completion&& other)
+    : m_operations(other.m_operations)
+    , m_storage()
+{
+    if (m_operations) {
+        m_operations->move(other.m_storage, m_storage);
+        other.m_operations = nullptr;
+    }
+}
+
+template <typename... Args>
+inline wamp_completion<void(std::exception_ptr, Args...)>&
+wamp_completion<void(std::exception_ptr, Args...)>::operator=(wamp_completion&& other)
+{
+    if (this != &other) {
+        if (m_operations) {
+            m_operations->destroy(m_storage);
+        }
+
+        m_operations = other.m_operations;
+        if (m_operations) {
+            m_operations->move(other.m_storage, m_storage);
+            other.m_operations = nullptr;
+        }
+    }
+
+    return *this;
+}
+
+template <typename... Args>
+inline wamp_completion<void(std::exception_ptr, Args...)>::~wamp_completion()
+{
+    if (m_operations) {
+        m_operations->destroy(m_storage);
+    }
+}
+
+template <typename... Args>
+inline wamp_completion<void(std::exception_ptr, Args...)>::operator bool() const
+{
+    return m_operations != nullptr;
+}
+
+template <typename... Args>
+inline void wamp_completion<void(std::exception_ptr, Args...)>::complete(
+        std::exception_ptr exception, Args... args)
+{
+    if (!m_operations) {
+        return;
+    }
+
+    const operations* completing = m_operations;
+    m_operations = nullptr;
+    completing->complete(m_storage, std::move(exception), std::move(args)...);
+}
+
+template <typename... Args>
+inline void wamp_completion<void(std::exception_ptr, Args...)>::fail(std::exception_ptr exception)
+{
+    complete(std::move(exception), typename std::decay<Args>::type()...);
+}
+
+template <typename T>
+inline void set_promise_exception(boost::promise<T>& promise, const std::exception_ptr& exception)
+{
+    // boost::current_exception() clones any std::runtime_error as a plain
+    // std::runtime_error, so the session's own errors are copied by their type
+    // to keep them catchable as such from the future.
+    try {
+        std::rethrow_exception(exception);
+    } catch (const canceled_error& e) {
+        promise.set_exception(boost::copy_exception(e));
+    } catch (const timeout_error& e) {
+        promise.set_exception(boost::copy_exception(e));
+    } catch (const protocol_error& e) {
+        promise.set_exception(boost::copy_exception(e));
+    } catch (const no_session_error& e) {
+        promise.set_exception(boost::copy_exception(e));
+    } catch (const no_transport_error& e) {
+        promise.set_exception(boost::copy_exception(e));
+    } catch (const network_error& e) {
+        promise.set_exception(boost::copy_exception(e));
+    } catch (const abort_error& e) {
+        promise.set_exception(boost::copy_exception(e));
+    } catch (...) {
+        promise.set_exception(boost::current_exception());
+    }
+}
+
+template <typename T>
+inline wamp_promise_handler<T>::wamp_promise_handler(boost::promise<T>&& promise)
+    : m_promise(std::move(promise))
+{
+}
+
+template <typename T>
+inline void wamp_promise_handler<T>::operator()(std::exception_ptr exception, T value)
+{
+    if (exception) {
+        set_promise_exception(m_promise, exception);
+    } else {
+        m_promise.set_value(std::move(value));
+    }
+}
+
+inline wamp_promise_handler<void>::wamp_promise_handler(boost::promise<void>&& promise)
+    : m_promise(std::move(promise))
+{
+}
+
+inline void wamp_promise_handler<void>::operator()(std::exception_ptr exception)
+{
+    if (exception) {
+        set_promise_exception(m_promise, exception);
+    } else {
+        m_promise.set_value();
+    }
+}
+
+} // namespace autobahn
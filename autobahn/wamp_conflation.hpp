@@ -0,0 +1,135 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Crossbar.io Technologies GmbH and contributors
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef AUTOBAHN_WAMP_CONFLATION_HPP
+#define AUTOBAHN_WAMP_CONFLATION_HPP
+
+#include "wamp_event.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace autobahn {
+
+/*!
+ * Counters of the events of the subscriptions conflated under one
+ * wamp_conflation, see wamp_conflation::metrics().
+ */
+class wamp_conflation_metrics
+{
+public:
+    wamp_conflation_metrics();
+    wamp_conflation_metrics(uint64_t received, uint64_t delivered, uint64_t conflated, std::size_t pending_keys);
+
+    /// Number of events received from the router.
+    uint64_t received() const;
+
+    /// Number of events handed to the handler.
+    uint64_t delivered() const;
+
+    /// Number of events dropped because a newer event with the same key arrived first.
+    uint64_t conflated() const;
+
+    /// Keys with an event waiting for the handler when the metrics were taken.
+    std::size_t pending_keys() const;
+
+private:
+    uint64_t m_received;
+    uint64_t m_delivered;
+    uint64_t m_conflated;
+    std::size_t m_pending_keys;
+};
+
+/*!
+ * Selects the conflation key of events, see wamp_session::subscribe().
+ *
+ * While the handler of a conflated subscription is busy, only the newest
+ * event per key waits for it; an older undelivered event with the same key
+ * is dropped without its arguments ever being converted. The events waiting
+ * are thus bounded by the number of distinct keys. Events lacking the key
+ * are never conflated; they wait for the handler in line with the others.
+ *
+ * Copies of a conflation refer to the same counters.
+ */
+class wamp_conflation
+{
+public:
+    /// Key events by their positional argument at @p index.
+    static wamp_conflation by_argument(std::size_t index);
+
+    /// Key events by their keyword argument @p key.
+    static wamp_conflation by_kw_argument(const std::string& key);
+
+    /// A snapshot of the counters.
+    wamp_conflation_metrics metrics() const;
+
+    //
+    // functions only called internally by wamp_conflating_event_channel
+
+    /*!
+     * Sets @p key to the key of @p event in its encoded form, so equal values
+     * of any type compare equal.
+     *
+     * @return false if the event lacks the key.
+     */
+    bool key_of(const wamp_event& event, std::string& key) const;
+
+    void record_received() const;
+    void record_delivered() const;
+    void record_conflated() const;
+    void record_pending_keys(std::ptrdiff_t change) const;
+
+private:
+    struct state
+    {
+        std::size_t m_index;
+        std::string m_kw_key;
+        bool m_by_kw_argument;
+
+        std::atomic<uint64_t> m_received;
+        std::atomic<uint64_t> m_delivered;
+        std::atomic<uint64_t> m_conflated;
+        std::atomic<std::ptrdiff_t> m_pending_keys;
+    };
+
+    wamp_conflation();
+
+    std::shared_ptr<state> m_state;
+};
+
+} // namespace autobahn
+
+#include "wamp_conflation.ipp"
+
+#endif // AUTOBAHN_WAMP_CONFLATION_HPP
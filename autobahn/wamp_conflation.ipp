@@ -0,0 +1,152 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Crossbar.io Technologies GmbH and contributors
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include <msgpack.hpp>
+
+#include <stdexcept>
+
+namespace autobahn {
+
+inline wamp_conflation_metrics::wamp_conflation_metrics()
+    : m_received(0)
+    , m_delivered(0)
+    , m_conflated(0)
+    , m_pending_keys(0)
+{
+}
+
+inline wamp_conflation_metrics::wamp_conflation_metrics(
+        uint64_t received, uint64_t delivered, uint64_t conflated, std::size_t pending_keys)
+    : m_received(received)
+    , m_delivered(delivered)
+    , m_conflated(conflated)
+    , m_pending_keys(pending_keys)
+{
+}
+
+inline uint64_t wamp_conflation_metrics::received() const
+{
+    return m_received;
+}
+
+inline uint64_t wamp_conflation_metrics::delivered() const
+{
+    return m_delivered;
+}
+
+inline uint64_t wamp_conflation_metrics::conflated() const
+{
+    return m_conflated;
+}
+
+inline std::size_t wamp_conflation_metrics::pending_keys() const
+{
+    return m_pending_keys;
+}
+
+inline wamp_conflation::wamp_conflation()
+    : m_state(std::make_shared<state>())
+{
+    m_state->m_index = 0;
+    m_state->m_by_kw_argument = false;
+    m_state->m_received = 0;
+    m_state->m_delivered = 0;
+    m_state->m_conflated = 0;
+    m_state->m_pending_keys = 0;
+}
+
+inline wamp_conflation wamp_conflation::by_argument(std::size_t index)
+{
+    wamp_conflation conflation;
+    conflation.m_state->m_index = index;
+    return conflation;
+}
+
+inline wamp_conflation wamp_conflation::by_kw_argument(const std::string& key)
+{
+    wamp_conflation conflation;
+    conflation.m_state->m_kw_key = key;
+    conflation.m_state->m_by_kw_argument = true;
+    return conflation;
+}
+
+inline wamp_conflation_metrics wamp_conflation::metrics() const
+{
+    std::ptrdiff_t pending_keys = m_state->m_pending_keys.load(std::memory_order_relaxed);
+    return wamp_conflation_metrics(
+            m_state->m_received.load(std::memory_order_relaxed),
+            m_state->m_delivered.load(std::memory_order_relaxed),
+            m_state->m_conflated.load(std::memory_order_relaxed),
+            pending_keys > 0 ? static_cast<std::size_t>(pending_keys) : 0);
+}
+
+inline bool wamp_conflation::key_of(const wamp_event& event, std::string& key) const
+{
+    // Only the key is looked at, the other arguments stay encoded.
+    msgpack::object value;
+    try {
+        if (m_state->m_by_kw_argument) {
+            value = event->kw_argument<msgpack::object>(m_state->m_kw_key);
+        } else {
+            value = event->argument<msgpack::object>(m_state->m_index);
+        }
+    } catch (const std::out_of_range&) {
+        return false;
+    }
+
+    msgpack::sbuffer buffer(64);
+    msgpack::packer<msgpack::sbuffer> packer(buffer);
+    packer.pack(value);
+    key.assign(buffer.data(), buffer.size());
+    return true;
+}
+
+inline void wamp_conflation::record_received() const
+{
+    m_state->m_received.fetch_add(1, std::memory_order_relaxed);
+}
+
+inline void wamp_conflation::record_delivered() const
+{
+    m_state->m_delivered.fetch_add(1, std::memory_order_relaxed);
+}
+
+inline void wamp_conflation::record_conflated() const
+{
+    m_state->m_conflated.fetch_add(1, std::memory_order_relaxed);
+}
+
+inline void wamp_conflation::record_pending_keys(std::ptrdiff_t change) const
+{
+    m_state->m_pending_keys.fetch_add(change, std::memory_order_relaxed);
+}
+
+} // namespace autobahn
@@ -0,0 +1,168 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Crossbar.io Technologies GmbH and contributors
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef AUTOBAHN_WAMP_COROUTINE_PROCEDURE_HPP
+#define AUTOBAHN_WAMP_COROUTINE_PROCEDURE_HPP
+
+#include <boost/asio/detail/config.hpp>
+
+#if defined(BOOST_ASIO_HAS_CO_AWAIT)
+
+#include "wamp_arguments.hpp"
+#include "wamp_invocation.hpp"
+#include "wamp_procedure.hpp"
+#include "wamp_registration.hpp"
+#include "boost_config.hpp"
+
+#include <boost/asio/awaitable.hpp>
+#include <boost/asio/co_spawn.hpp>
+
+#include <exception>
+#include <map>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace autobahn {
+
+template <typename T>
+struct is_awaitable : std::false_type
+{
+};
+
+template <typename T, typename Executor>
+struct is_awaitable<boost::asio::awaitable<T, Executor>> : std::true_type
+{
+};
+
+/*!
+ * Whether Function is a coroutine procedure, i.e. it takes a wamp_invocation
+ * and returns a boost::asio::awaitable.
+ */
+template <typename Function, typename = void>
+struct is_coroutine_procedure : std::false_type
+{
+};
+
+template <typename Function>
+struct is_coroutine_procedure<Function, typename std::enable_if<
+        std::is_invocable<Function&, wamp_invocation>::value>::type>
+    : is_awaitable<typename std::invoke_result<Function&, wamp_invocation>::type>
+{
+};
+
+/// Result of wamp_session::provide() for coroutine procedures.
+template <typename Function>
+using coroutine_provide_future = typename std::enable_if<
+        is_coroutine_procedure<typename std::decay<Function>::type>::value,
+        boost::future<wamp_registration>>::type;
+
+inline void yield_coroutine_error(const wamp_invocation& invocation, const std::exception_ptr& exception)
+{
+    if (!invocation->sendable()) {
+        return;
+    }
+
+    try {
+        std::rethrow_exception(exception);
+    } catch (const std::exception& e) {
+        std::map<std::string, std::string> error_kw_arguments;
+        error_kw_arguments["what"] = e.what();
+        invocation->error("wamp.error.runtime_error", EMPTY_ARGUMENTS, error_kw_arguments);
+    } catch (...) {
+        invocation->error("wamp.error.runtime_error");
+    }
+}
+
+template <typename T>
+struct coroutine_yield
+{
+    wamp_invocation invocation;
+
+    void operator()(std::exception_ptr exception, T arguments) const
+    {
+        if (exception) {
+            yield_coroutine_error(invocation, exception);
+        } else if (invocation->sendable()) {
+            invocation->result(arguments);
+        }
+    }
+};
+
+template <>
+struct coroutine_yield<void>
+{
+    wamp_invocation invocation;
+
+    void operator()(std::exception_ptr exception) const
+    {
+        if (exception) {
+            yield_coroutine_error(invocation, exception);
+        } else if (invocation->sendable()) {
+            invocation->empty_result();
+        }
+    }
+};
+
+/*!
+ * Adapts a coroutine procedure to a wamp_procedure. Each invocation runs the
+ * coroutine on the given executor; its co_returned value is sent as the positional
+ * arguments of the result, a coroutine returning awaitable<void> sends an empty
+ * result, and an escaping exception is sent as wamp.error.runtime_error.
+ *
+ * Coroutine frames are allocated through Asio's per-thread recycling allocator.
+ * Since a session processes its invocations on the thread running its io_service,
+ * frames of consecutive invocations reuse the same memory instead of going to the
+ * global heap.
+ */
+template <typename Executor, typename Function>
+inline wamp_procedure make_coroutine_procedure(const Executor& executor, Function&& function)
+{
+    using function_type = typename std::decay<Function>::type;
+    using awaitable_type = typename std::invoke_result<function_type&, wamp_invocation>::type;
+    using value_type = typename awaitable_type::value_type;
+
+    auto shared_function = std::make_shared<function_type>(std::forward<Function>(function));
+    return [executor, shared_function](wamp_invocation invocation) {
+        // The spawned function keeps the procedure alive until the coroutine is done,
+        // even if it is unregistered in the meantime.
+        boost::asio::co_spawn(executor,
+                [shared_function, invocation]() { return (*shared_function)(invocation); },
+                coroutine_yield<value_type>{invocation});
+    };
+}
+
+} // namespace autobahn
+
+#endif // defined(BOOST_ASIO_HAS_CO_AWAIT)
+
+#endif // AUTOBAHN_WAMP_COROUTINE_PROCEDURE_HPP
@@ -69,12 +69,36 @@ public:
      * Example:
      * `std::string id = event.argument<std::string>(0); // first positional argument`
      *
+     * String and binary arguments can be accessed without copying them by using a view type
+     * for T: `boost::string_view` (or `std::string_view` with C++17) for strings and
+     * `autobahn::span<const uint8_t>` for binaries. Views point into the received message
+     * and stay valid for the lifetime of the event.
+     *
      * @throw std::out_of_range
      * @throw std::bad_cast
      */
     template <typename T>
     T argument(std::size_t index) const;
 
+    /*!
+     * Convert and assign the positional argument of the event with the given @p index to @p value.
+     *
+     * The storage of @p value is reused, so decoding into the same container again and again
+     * does not allocate. Arrays of numbers decoded into a `std::vector` take a fast path for
+     * arrays holding only floating point or only integer numbers.
+     *
+     * Example:
+     * ```
+     * std::vector<double> frame;
+     * event.get_argument(0, frame);
+     * ```
+     *
+     * @throw std::out_of_range
+     * @throw std::bad_cast
+     */
+    template <typename T>
+    void get_argument(std::size_t index, T& value) const;
+
     /*!
      * The positional arguments published by the event, converted to a list type.
      *
@@ -122,17 +146,18 @@ public:
     /*!
      * The keyword argument published by the event with the given @p key, converted to type T.
      *
-     * Overloads are provided for `std::string` and `char*` as @p key type.
+     * Overloads are provided for `std::string`, `char*` and `wamp_key` as @p key type.
      *
-     * This function uses key string comparisons to find the matching value, O(n) with n being
-     * the number of map elements. Memory allocation for keys is avoided though. For larger maps,
-     * you might want to prioritize look-up performance by using `std::map`, `std::unordered_map`
-     * or custom types with custom deserialization. To do this, use kw_arguments<Map>() or
-     * get_kw_arguments<Map>(map), then access the items from there.
+     * Small maps are scanned using key string comparisons. Larger maps are indexed by a
+     * hash table built on first access, so subsequent look-ups are O(1). Memory allocation
+     * for keys is avoided either way. Declare constant keys as `constexpr wamp_key` to have
+     * them hashed at compile time.
      *
      * Example:
      * `std::string id = event.kw_argument<std::string>("id");`
      *
+     * View types can be used for T as described for argument().
+     *
      * @throw std::out_of_range
      * @throw std::bad_cast
      */
@@ -142,17 +167,19 @@ public:
     template <typename T>
     T kw_argument(const char* key) const;
 
+    template <typename T>
+    T kw_argument(const wamp_key& key) const;
+
     /*!
      * The keyword argument published by the event with the given @p key, converted to type T,
      * or the given @p fallback if no such key was passed.
      *
-     * Overloads are provided for `std::string` and `char*` as @p key type.
+     * Overloads are provided for `std::string`, `char*` and `wamp_key` as @p key type.
      *
-     * This function uses key string comparisons to find the matching value, O(n) with n being
-     * the number of map elements. Memory allocation for keys is avoided though. For larger maps,
-     * you might want to prioritize look-up performance by using `std::map`, `std::unordered_map`
-     * or custom types with custom deserialization. To do this, use kw_arguments<Map>() or
-     * get_kw_arguments<Map>(map), then access the items from there.
+     * Small maps are scanned using key string comparisons. Larger maps are indexed by a
+     * hash table built on first access, so subsequent look-ups are O(1). Memory allocation
+     * for keys is avoided either way. Declare constant keys as `constexpr wamp_key` to have
+     * them hashed at compile time.
      *
      * Example:
      * `std::string id = event.kw_argument_or("id", std::string());`
@@ -165,6 +192,9 @@ public:
     template <typename T>
     T kw_argument_or(const char* key, const T& fallback) const;
 
+    template <typename T>
+    T kw_argument_or(const wamp_key& key, const T& fallback) const;
+
     /*!
      * The keyword arguments published by the event, converted to a map type.
      *
@@ -201,6 +231,7 @@ private:
     msgpack::zone m_zone;
     msgpack::object m_arguments;
     msgpack::object m_kw_arguments;
+    wamp_map_index m_kw_arguments_index;
     std::string m_uri;
 
 };
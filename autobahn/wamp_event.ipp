@@ -62,7 +62,16 @@ inline T wamp_event_impl::argument(std::size_t index) const
     if (m_arguments.type != msgpack::type::ARRAY || m_arguments.via.array.size <= index) {
         throw std::out_of_range("no argument at index " + boost::lexical_cast<std::string>(index));
     }
-    return m_arguments.via.array.ptr[index].as<T>();
+    return argument_as<T>(m_arguments.via.array.ptr[index]);
+}
+
+template <typename T>
+inline void wamp_event_impl::get_argument(std::size_t index, T& value) const
+{
+    if (m_arguments.type != msgpack::type::ARRAY || m_arguments.via.array.size <= index) {
+        throw std::out_of_range("no argument at index " + boost::lexical_cast<std::string>(index));
+    }
+    convert_argument(m_arguments.via.array.ptr[index], value);
 }
 
 template <typename List>
@@ -87,71 +96,42 @@ inline void wamp_event_impl::get_each_argument(T&... args) const
 template <typename T>
 inline T wamp_event_impl::kw_argument(const std::string& key) const
 {
-    if (m_kw_arguments.type != msgpack::type::MAP) {
-        throw msgpack::type_error();
-    }
-    for (std::size_t i = 0; i < m_kw_arguments.via.map.size; ++i) {
-        const msgpack::object_kv& kv = m_kw_arguments.via.map.ptr[i];
-        if (kv.key.type == msgpack::type::STR && key.size() == kv.key.via.str.size
-                && key.compare(0, key.size(), kv.key.via.str.ptr, kv.key.via.str.size) == 0)
-        {
-            return kv.val.as<T>();
-        }
-    }
-    throw std::out_of_range(key + " keyword argument doesn't exist");
+    return kw_argument<T>(wamp_key(key));
 }
 
 template <typename T>
 inline T wamp_event_impl::kw_argument(const char* key) const
 {
-    if (m_kw_arguments.type != msgpack::type::MAP) {
-        throw msgpack::type_error();
-    }
-    std::size_t key_size = strlen(key);
-    for (std::size_t i = 0; i < m_kw_arguments.via.map.size; ++i) {
-        const msgpack::object_kv& kv = m_kw_arguments.via.map.ptr[i];
-        if (kv.key.type == msgpack::type::STR && key_size == kv.key.via.str.size
-                && memcmp(key, kv.key.via.str.ptr, key_size) == 0)
-        {
-            return kv.val.as<T>();
-        }
+    return kw_argument<T>(wamp_key(key, strlen(key)));
+}
+
+template <typename T>
+inline T wamp_event_impl::kw_argument(const wamp_key& key) const
+{
+    const msgpack::object* value = m_kw_arguments_index.find(m_kw_arguments, key);
+    if (!value) {
+        throw std::out_of_range(key.str() + " keyword argument doesn't exist");
     }
-    throw std::out_of_range(std::string(key) + " keyword argument doesn't exist");
+    return argument_as<T>(*value);
 }
 
 template <typename T>
 inline T wamp_event_impl::kw_argument_or(const std::string& key, const T& fallback) const
 {
-    if (m_kw_arguments.type != msgpack::type::MAP) {
-        throw msgpack::type_error();
-    }
-    for (std::size_t i = 0; i < m_kw_arguments.via.map.size; ++i) {
-        const msgpack::object_kv& kv = m_kw_arguments.via.map.ptr[i];
-        if (kv.key.type == msgpack::type::STR && key.size() == kv.key.via.str.size
-                && key.compare(0, key.size(), kv.key.via.str.ptr, kv.key.via.str.size) == 0)
-        {
-            return kv.val.as<T>();
-        }
-    }
-    return fallback;
+    return kw_argument_or<T>(wamp_key(key), fallback);
 }
 
 template <typename T>
 inline T wamp_event_impl::kw_argument_or(const char* key, const T& fallback) const
 {
-    if (m_kw_arguments.type != msgpack::type::MAP) {
-        throw msgpack::type_error();
-    }
-    std::size_t key_size = strlen(key);
-    for (std::size_t i = 0; i < m_kw_arguments.via.map.size; ++i) {
-        const msgpack::object_kv& kv = m_kw_arguments.via.map.ptr[i];
-        if (kv.key.type == msgpack::type::STR && key_size == kv.key.via.str.size
-                && memcmp(key, kv.key.via.str.ptr, key_size) == 0)
-        {
-            return kv.val.as<T>();
-        }
-    }
-    throw fallback;
+    return kw_argument_or<T>(wamp_key(key, strlen(key)), fallback);
+}
+
+template <typename T>
+inline T wamp_event_impl::kw_argument_or(const wamp_key& key, const T& fallback) const
+{
+    const msgpack::object* value = m_kw_arguments_index.find(m_kw_arguments, key);
+    return value ? argument_as<T>(*value) : fallback;
 }
 
 template <typename Map>
@@ -174,6 +154,7 @@ inline void wamp_event_impl::set_arguments(const msgpack::object& arguments)
 inline void wamp_event_impl::set_kw_arguments(const msgpack::object& kw_arguments)
 {
     m_kw_arguments = kw_arguments;
+    m_kw_arguments_index.reset();
 }
 
 inline void wamp_event_impl::set_details(const msgpack::object& details)
@@ -0,0 +1,159 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Crossbar.io Technologies GmbH and contributors
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef AUTOBAHN_WAMP_EVENT_CHANNEL_HPP
+#define AUTOBAHN_WAMP_EVENT_CHANNEL_HPP
+
+#include "wamp_conflation.hpp"
+#include "wamp_event.hpp"
+#include "wamp_event_handler.hpp"
+
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace autobahn {
+
+/*!
+ * Delivers the events of one subscription handler on an executor.
+ *
+ * Events are queued in the order they are pushed and handed to the handler
+ * one after the other, so a subscription sees its events in order while
+ * channels of other subscriptions run in parallel on the same executor.
+ * Queue nodes are recycled, so a steady event stream does not allocate.
+ *
+ * @tparam Executor The executor the handler runs on, e.g. a thread pool
+ *                  executor or a strand.
+ */
+template <typename Executor>
+class wamp_event_channel :
+        public std::enable_shared_from_this<wamp_event_channel<Executor>>
+{
+public:
+    wamp_event_channel(const Executor& executor, const wamp_event_handler& handler);
+    ~wamp_event_channel();
+
+    wamp_event_channel(const wamp_event_channel&) = delete;
+    wamp_event_channel& operator=(const wamp_event_channel&) = delete;
+
+    /// Queue an event, scheduling the handler if it is not running yet.
+    void push(const wamp_event& event);
+
+private:
+    struct node
+    {
+        wamp_event m_event;
+        node* m_next;
+    };
+
+    void run();
+    void recycle(node* first, node* last, std::size_t count);
+
+    Executor m_executor;
+    wamp_event_handler m_handler;
+
+    std::mutex m_mutex;
+    node* m_head;
+    node* m_tail;
+    node* m_free;
+    std::size_t m_free_count;
+    bool m_scheduled;
+};
+
+/*!
+ * Wrap @p handler so that it is invoked through a wamp_event_channel on
+ * @p executor rather than inline by the session.
+ */
+template <typename Executor>
+wamp_event_handler make_executor_event_handler(const Executor& executor, const wamp_event_handler& handler);
+
+/*!
+ * Delivers the events of one subscription handler on an executor, keeping
+ * only the newest undelivered event per conflation key.
+ *
+ * An event replacing an undelivered one takes over its place in line, so
+ * keys are served in the order they first became pending and a busy key
+ * cannot starve the others. Events lacking the key are queued unconflated.
+ *
+ * @tparam Executor The executor the handler runs on, e.g. a thread pool
+ *                  executor or a strand.
+ */
+template <typename Executor>
+class wamp_conflating_event_channel :
+        public std::enable_shared_from_this<wamp_conflating_event_channel<Executor>>
+{
+public:
+    wamp_conflating_event_channel(
+            const Executor& executor, const wamp_event_handler& handler, const wamp_conflation& conflation);
+
+    wamp_conflating_event_channel(const wamp_conflating_event_channel&) = delete;
+    wamp_conflating_event_channel& operator=(const wamp_conflating_event_channel&) = delete;
+
+    /// Queue an event, replacing an undelivered one with the same key.
+    void push(const wamp_event& event);
+
+private:
+    // A place in line: a key whose newest event waits in m_pending, or an
+    // event lacking the key, which is held here.
+    struct turn
+    {
+        std::string m_key;
+        wamp_event m_unkeyed;
+    };
+
+    void run();
+
+    Executor m_executor;
+    wamp_event_handler m_handler;
+    wamp_conflation m_conflation;
+
+    std::mutex m_mutex;
+    std::deque<turn> m_order;
+    std::unordered_map<std::string, wamp_event> m_pending;
+    bool m_scheduled;
+};
+
+/*!
+ * Wrap @p handler so that it is invoked through a wamp_conflating_event_channel
+ * on @p executor rather than inline by the session.
+ */
+template <typename Executor>
+wamp_event_handler make_conflating_event_handler(
+        const Executor& executor, const wamp_event_handler& handler, const wamp_conflation& conflation);
+
+} // namespace autobahn
+
+#include "wamp_event_channel.ipp"
+
+#endif // AUTOBAHN_WAMP_EVENT_CHANNEL_HPP
@@ -0,0 +1,265 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Crossbar.io Technologies GmbH and contributors
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include <boost/asio/post.hpp>
+
+#include <exception>
+#include <iostream>
+
+namespace autobahn {
+
+// Recycled nodes kept per channel; beyond this, drained nodes are freed.
+static const std::size_t WAMP_EVENT_CHANNEL_MAX_FREE_NODES = 64;
+
+template <typename Executor>
+inline wamp_event_channel<Executor>::wamp_event_channel(
+        const Executor& executor, const wamp_event_handler& handler)
+    : m_executor(executor)
+    , m_handler(handler)
+    , m_mutex()
+    , m_head(nullptr)
+    , m_tail(nullptr)
+    , m_free(nullptr)
+    , m_free_count(0)
+    , m_scheduled(false)
+{
+}
+
+template <typename Executor>
+inline wamp_event_channel<Executor>::~wamp_event_channel()
+{
+    while (m_head) {
+        node* next = m_head->m_next;
+        delete m_head;
+        m_head = next;
+    }
+    while (m_free) {
+        node* next = m_free->m_next;
+        delete m_free;
+        m_free = next;
+    }
+}
+
+template <typename Executor>
+inline void wamp_event_channel<Executor>::push(const wamp_event& event)
+{
+    bool schedule = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        node* queued = m_free;
+        if (queued) {
+            m_free = queued->m_next;
+            --m_free_count;
+            queued->m_event = event;
+            queued->m_next = nullptr;
+        } else {
+            queued = new node{event, nullptr};
+        }
+
+        if (m_tail) {
+            m_tail->m_next = queued;
+        } else {
+            m_head = queued;
+        }
+        m_tail = queued;
+
+        schedule = !m_scheduled;
+        m_scheduled = true;
+    }
+
+    if (schedule) {
+        auto self = this->shared_from_this();
+        boost::asio::post(m_executor, [self]() {
+            self->run();
+        });
+    }
+}
+
+template <typename Executor>
+inline void wamp_event_channel<Executor>::run()
+{
+    for (;;) {
+        node* first = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            first = m_head;
+            if (!first) {
+                m_scheduled = false;
+                return;
+            }
+            m_head = m_tail = nullptr;
+        }
+
+        // Only one run() is scheduled at a time, which keeps the events of
+        // this channel in order.
+        node* last = first;
+        std::size_t count = 0;
+        for (node* current = first; current; current = current->m_next) {
+            try {
+                m_handler(current->m_event);
+            } catch (const std::exception& e) {
+                std::cerr << "Warning: event handler threw exception: " << e.what() << std::endl;
+            } catch (...) {
+                std::cerr << "Warning: event handler threw exception" << std::endl;
+            }
+            current->m_event.reset();
+            last = current;
+            ++count;
+        }
+
+        recycle(first, last, count);
+    }
+}
+
+template <typename Executor>
+inline void wamp_event_channel<Executor>::recycle(node* first, node* last, std::size_t count)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    while (first && m_free_count + count > WAMP_EVENT_CHANNEL_MAX_FREE_NODES) {
+        node* next = first->m_next;
+        delete first;
+        first = next;
+        --count;
+    }
+    if (first) {
+        last->m_next = m_free;
+        m_free = first;
+        m_free_count += count;
+    }
+}
+
+template <typename Executor>
+inline wamp_event_handler make_executor_event_handler(const Executor& executor, const wamp_event_handler& handler)
+{
+    auto channel = std::make_shared<wamp_event_channel<Executor>>(executor, handler);
+    return [channel](const wamp_event& event) {
+        channel->push(event);
+    };
+}
+
+template <typename Executor>
+inline wamp_conflating_event_channel<Executor>::wamp_conflating_event_channel(
+        const Executor& executor, const wamp_event_handler& handler, const wamp_conflation& conflation)
+    : m_executor(executor)
+    , m_handler(handler)
+    , m_conflation(conflation)
+    , m_mutex()
+    , m_order()
+    , m_pending()
+    , m_scheduled(false)
+{
+}
+
+template <typename Executor>
+inline void wamp_conflating_event_channel<Executor>::push(const wamp_event& event)
+{
+    std::string key;
+    const bool keyed = m_conflation.key_of(event, key);
+    m_conflation.record_received();
+
+    bool schedule = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (!keyed) {
+            m_order.push_back(turn{std::string(), event});
+        } else {
+            auto pending = m_pending.emplace(key, event);
+            if (pending.second) {
+                m_order.push_back(turn{std::move(key), wamp_event()});
+                m_conflation.record_pending_keys(1);
+            } else {
+                pending.first->second = event;
+                m_conflation.record_conflated();
+            }
+        }
+
+        schedule = !m_scheduled;
+        m_scheduled = true;
+    }
+
+    if (schedule) {
+        auto self = this->shared_from_this();
+        boost::asio::post(m_executor, [self]() {
+            self->run();
+        });
+    }
+}
+
+template <typename Executor>
+inline void wamp_conflating_event_channel<Executor>::run()
+{
+    for (;;) {
+        wamp_event event;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_order.empty()) {
+                m_scheduled = false;
+                return;
+            }
+
+            // Taking one event at a time leaves the rest open to conflation
+            // while the handler runs.
+            turn& next = m_order.front();
+            if (next.m_unkeyed) {
+                event = std::move(next.m_unkeyed);
+            } else {
+                auto pending = m_pending.find(next.m_key);
+                event = std::move(pending->second);
+                m_pending.erase(pending);
+                m_conflation.record_pending_keys(-1);
+            }
+            m_order.pop_front();
+        }
+
+        m_conflation.record_delivered();
+        try {
+            m_handler(event);
+        } catch (const std::exception& e) {
+            std::cerr << "Warning: event handler threw exception: " << e.what() << std::endl;
+        } catch (...) {
+            std::cerr << "Warning: event handler threw exception" << std::endl;
+        }
+    }
+}
+
+template <typename Executor>
+inline wamp_event_handler make_conflating_event_handler(
+        const Executor& executor, const wamp_event_handler& handler, const wamp_conflation& conflation)
+{
+    auto channel = std::make_shared<wamp_conflating_event_channel<Executor>>(executor, handler, conflation);
+    return [channel](const wamp_event& event) {
+        channel->push(event);
+    };
+}
+
+} // namespace autobahn
@@ -31,13 +31,24 @@
 #ifndef AUTOBAHN_WAMP_EVENT_HANDLER_HPP
 #define AUTOBAHN_WAMP_EVENT_HANDLER_HPP
 
+#include "span.hpp"
 #include "wamp_event.hpp"
 
+#include <boost/container/small_vector.hpp>
+
+#include <functional>
+
 namespace autobahn {
 
 /// Handler type for use with wamp_session::subscribe
 typedef std::function<void(const wamp_event&)> wamp_event_handler;
 
+/// Handler type for use with wamp_session::subscribe_batch
+typedef std::function<void(span<const wamp_event>)> wamp_batch_event_handler;
+
+/// Event handlers sharing a subscription, stored inline for the common single handler.
+typedef boost::container::small_vector<wamp_event_handler, 1> wamp_event_handlers;
+
 } // namespace autobahn
 
 #endif // AUTOBAHN_WAMP_EVENT_HANDLER_HPP
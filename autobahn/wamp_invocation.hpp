@@ -32,20 +32,29 @@
 #define AUTOBAHN_WAMP_INVOCATION_HPP
 
 #include "wamp_arguments.hpp"
+#include "wamp_call_handle.hpp"
+#include "wamp_call_result.hpp"
 
 #include <msgpack/zone.hpp>
 #include <msgpack/object.hpp>
 
+#include <atomic>
 #include <cstdint>
+#include <deque>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <string>
 
 namespace autobahn {
 
 class wamp_message;
 
-class wamp_invocation_impl
+class wamp_invocation_impl;
+
+using wamp_invocation = std::shared_ptr<wamp_invocation_impl>;
+
+class wamp_invocation_impl : public std::enable_shared_from_this<wamp_invocation_impl>
 {
 public:
     wamp_invocation_impl();
@@ -74,12 +83,36 @@ public:
      * Example:
      * `std::string id = invocation->argument<std::string>(0); // first positional argument`
      *
+     * String and binary arguments can be accessed without copying them by using a view type
+     * for T: `boost::string_view` (or `std::string_view` with C++17) for strings and
+     * `autobahn::span<const uint8_t>` for binaries. Views point into the received message
+     * and stay valid for the lifetime of the invocation.
+     *
      * @throw std::out_of_range
      * @throw std::bad_cast
      */
     template <typename T>
     T argument(std::size_t index) const;
 
+    /*!
+     * Convert and assign the positional argument of the invocation with the given @p index to @p value.
+     *
+     * The storage of @p value is reused, so decoding into the same container again and again
+     * does not allocate. Arrays of numbers decoded into a `std::vector` take a fast path for
+     * arrays holding only floating point or only integer numbers.
+     *
+     * Example:
+     * ```
+     * std::vector<double> frame;
+     * invocation->get_argument(0, frame);
+     * ```
+     *
+     * @throw std::out_of_range
+     * @throw std::bad_cast
+     */
+    template <typename T>
+    void get_argument(std::size_t index, T& value) const;
+
     /*!
      * The positional arguments passed to the invocation, converted to a list type.
      *
@@ -127,17 +160,18 @@ public:
     /*!
      * The keyword argument passed to the invocation with the given @p key, converted to type T.
      *
-     * Overloads are provided for `std::string` and `char*` as @p key type.
+     * Overloads are provided for `std::string`, `char*` and `wamp_key` as @p key type.
      *
-     * This function uses key string comparisons to find the matching value, O(n) with n being
-     * the number of map elements. Memory allocation for keys is avoided though. For larger maps,
-     * you might want to prioritize look-up performance by using `std::map`, `std::unordered_map`
-     * or custom types with custom deserialization. To do this, use kw_arguments<Map>() or
-     * get_kw_arguments<Map>(map), then access the items from there.
+     * Small maps are scanned using key string comparisons. Larger maps are indexed by a
+     * hash table built on first access, so subsequent look-ups are O(1). Memory allocation
+     * for keys is avoided either way. Declare constant keys as `constexpr wamp_key` to have
+     * them hashed at compile time.
      *
      * Example:
      * `std::string id = invocation->kw_argument<std::string>("id");`
      *
+     * View types can be used for T as described for argument().
+     *
      * @throw std::out_of_range
      * @throw std::bad_cast
      */
@@ -147,17 +181,19 @@ public:
     template <typename T>
     T kw_argument(const char* key) const;
 
+    template <typename T>
+    T kw_argument(const wamp_key& key) const;
+
     /*!
      * The keyword argument passed to the invocation with the given @p key, converted to type T,
      * or the given @p fallback if no such key was passed.
      *
-     * Overloads are provided for `std::string` and `char*` as @p key type.
+     * Overloads are provided for `std::string`, `char*` and `wamp_key` as @p key type.
      *
-     * This function uses key string comparisons to find the matching value, O(n) with n being
-     * the number of map elements. Memory allocation for keys is avoided though. For larger maps,
-     * you might want to prioritize look-up performance by using `std::map`, `std::unordered_map`
-     * or custom types with custom deserialization. To do this, use kw_arguments<Map>() or
-     * get_kw_arguments<Map>(map), then access the items from there.
+     * Small maps are scanned using key string comparisons. Larger maps are indexed by a
+     * hash table built on first access, so subsequent look-ups are O(1). Memory allocation
+     * for keys is avoided either way. Declare constant keys as `constexpr wamp_key` to have
+     * them hashed at compile time.
      *
      * Example:
      * `std::string id = invocation->kw_argument_or("id", std::string());`
@@ -170,6 +206,9 @@ public:
     template <typename T>
     T kw_argument_or(const char* key, const T& fallback) const;
 
+    template <typename T>
+    T kw_argument_or(const wamp_key& key, const T& fallback) const;
+
     /*!
      * The keyword arguments passed to the invocation, converted to a map type.
      *
@@ -198,17 +237,18 @@ public:
     /*!
     * The call detail passed to the invocation with the given @p key, converted to type T.
     *
-    * Overloads are provided for `std::string` and `char*` as @p key type.
+    * Overloads are provided for `std::string`, `char*` and `wamp_key` as @p key type.
     *
-    * This function uses key string comparisons to find the matching value, O(n) with n being
-    * the number of map elements. Memory allocation for keys is avoided though. For larger maps,
-    * you might want to prioritize look-up performance by using `std::map`, `std::unordered_map`
-    * or custom types with custom deserialization. To do this, use details<Map>() or
-    * get_details<Map>(map), then access the items from there.
+    * Small maps are scanned using key string comparisons. Larger maps are indexed by a
+    * hash table built on first access, so subsequent look-ups are O(1). Memory allocation
+    * for keys is avoided either way. Declare constant keys as `constexpr wamp_key` to have
+    * them hashed at compile time.
     *
     * Example:
     * `std::string caller_authid = invocation->detail<std::string>("caller_authid");`
     *
+    * View types can be used for T as described for argument().
+    *
     * @throw std::out_of_range
     * @throw std::bad_cast
     */
@@ -218,17 +258,19 @@ public:
     template <typename T>
     T detail(const char* key) const;
 
+    template <typename T>
+    T detail(const wamp_key& key) const;
+
     /*!
     * The call detail passed to the invocation with the given @p key, converted to type T,
     * or the given @p fallback if no such key was passed.
     *
-    * Overloads are provided for `std::string` and `char*` as @p key type.
+    * Overloads are provided for `std::string`, `char*` and `wamp_key` as @p key type.
     *
-    * This function uses key string comparisons to find the matching value, O(n) with n being
-    * the number of map elements. Memory allocation for keys is avoided though. For larger maps,
-    * you might want to prioritize look-up performance by using `std::map`, `std::unordered_map`
-    * or custom types with custom deserialization. To do this, use details<Map>() or
-    * get_details<Map>(map), then access the items from there.
+    * Small maps are scanned using key string comparisons. Larger maps are indexed by a
+    * hash table built on first access, so subsequent look-ups are O(1). Memory allocation
+    * for keys is avoided either way. Declare constant keys as `constexpr wamp_key` to have
+    * them hashed at compile time.
     *
     * Example:
     * `std::string caller_authid = invocation->detail_or("caller_authid", std::string());`
@@ -241,6 +283,9 @@ public:
     template <typename T>
     T detail_or(const char* key, const T& fallback) const;
 
+    template <typename T>
+    T detail_or(const wamp_key& key, const T& fallback) const;
+
     /*!
     * The call details passed to the invocation, converted to a map type.
     *
@@ -270,6 +315,65 @@ public:
     */
     bool progressive_results_expected() const;
 
+    /*!
+     * Checks if the caller canceled the call and the dealer interrupted the invocation.
+     *
+     * Long running procedures should poll this between units of work and return
+     * early once it is set. The session has then already replied to the dealer
+     * with `wamp.error.canceled`, and any result or error sent afterwards is dropped.
+     */
+    bool canceled() const;
+
+    /*!
+     * The mode the dealer interrupted the invocation with. Only meaningful once
+     * canceled() is set.
+     */
+    wamp_cancel_mode cancel_mode() const;
+
+    /*!
+     * Registers a @p handler to be run when the invocation is interrupted, instead
+     * of (or in addition to) polling canceled(). The handler runs on the io_service
+     * thread, or right away if the invocation was interrupted already. Registering
+     * another handler replaces the previous one.
+     */
+    void on_cancel(std::function<void()> handler);
+
+    /*!
+     * Checks if the caller is still sending arguments in chunks (progressive call
+     * invocations), i.e. further chunks follow the arguments of the invocation, or
+     * the chunk being handled by the on_arguments() handler.
+     */
+    bool more_arguments_expected() const;
+
+    using arguments_handler = std::function<void(const wamp_invocation& invocation, wamp_call_result&& chunk)>;
+
+    /*!
+     * Registers a @p handler receiving the further chunks of arguments of a progressive
+     * call invocation. Each chunk is handed to the handler as a value of its own, on the
+     * io_service thread, and released once the handler returns unless it is moved away.
+     * The arguments of the invocation itself stay the ones of the first chunk.
+     *
+     * Chunks arriving before a handler is registered are held back and passed to it
+     * once it is. At most 64 chunks are held back; beyond that the invocation fails with
+     * `wamp.error.runtime_error` rather than buffering the call without bound. The
+     * procedure still replies once, usually after the last chunk, which is the one
+     * handled with more_arguments_expected() unset.
+     *
+     * Example:
+     * ```
+     * void upload(autobahn::wamp_invocation invocation) {
+     *     consume(invocation->argument<std::string>(0));
+     *     invocation->on_arguments([](const autobahn::wamp_invocation& invocation, autobahn::wamp_call_result&& chunk) {
+     *         consume(chunk.argument<std::string>(0));
+     *         if (!invocation->more_arguments_expected()) {
+     *             invocation->empty_result();
+     *         }
+     *     });
+     * }
+     * ```
+     */
+    void on_arguments(arguments_handler handler);
+
     /*!
      * Reply to the invocation with an empty result.
      */
@@ -333,10 +437,17 @@ public:
     void set_zone(msgpack::zone&&);
     void set_arguments(const msgpack::object& arguments);
     void set_kw_arguments(const msgpack::object& kw_arguments);
+    void interrupt(wamp_cancel_mode mode);
+    void push_arguments(
+            msgpack::zone&& zone,
+            const msgpack::object& details,
+            const msgpack::object& arguments,
+            const msgpack::object& kw_arguments);
     bool sendable() const;
 
 private:
     void throw_if_not_sendable() const;
+    void deliver_arguments();
 
     template <typename List>
     void send_result(const List& arguments, result_type resultType);
@@ -349,14 +460,33 @@ private:
     msgpack::zone m_zone;
     msgpack::object m_arguments;
     msgpack::object m_kw_arguments;
+    wamp_map_index m_kw_arguments_index;
     msgpack::object m_details;
+    wamp_map_index m_details_index;
     send_result_fn m_send_result_fn;
     std::uint64_t m_request_id;
     std::string m_uri;
     bool m_progressive_results_expected;
-};
 
-using wamp_invocation = std::shared_ptr<wamp_invocation_impl>;
+    // Set from the io_service thread when an INTERRUPT arrives.
+    std::mutex m_cancel_mutex;
+    std::atomic<bool> m_canceled;
+    wamp_cancel_mode m_cancel_mode;
+    std::function<void()> m_cancel_handler;
+
+    // Chunks of arguments of a progressive call invocation, see on_arguments().
+    struct arguments_chunk
+    {
+        wamp_call_result arguments;
+        bool more;
+    };
+
+    std::mutex m_arguments_mutex;
+    std::deque<arguments_chunk> m_pending_arguments;
+    arguments_handler m_arguments_handler;
+    bool m_delivering_arguments;
+    std::atomic<bool> m_more_arguments_expected;
+};
 
 } // namespace autobahn
 
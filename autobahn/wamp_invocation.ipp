@@ -37,6 +37,9 @@
 
 namespace autobahn {
 
+// Chunks of a progressive call invocation held back until on_arguments() is called.
+static const std::size_t WAMP_INVOCATION_MAX_PENDING_CHUNKS = 64;
+
 inline wamp_invocation_impl::wamp_invocation_impl()
     : m_zone()
     , m_arguments(EMPTY_ARGUMENTS)
@@ -44,6 +47,15 @@ inline wamp_invocation_impl::wamp_invocation_impl()
     , m_send_result_fn()
     , m_request_id(0)
     , m_progressive_results_expected(false)
+    , m_cancel_mutex()
+    , m_canceled(false)
+    , m_cancel_mode(wamp_cancel_mode::kill)
+    , m_cancel_handler()
+    , m_arguments_mutex()
+    , m_pending_arguments()
+    , m_arguments_handler()
+    , m_delivering_arguments(false)
+    , m_more_arguments_expected(false)
 {
 }
 
@@ -75,7 +87,16 @@ inline T wamp_invocation_impl::argument(std::size_t index) const
     if (m_arguments.type != msgpack::type::ARRAY || m_arguments.via.array.size <= index) {
         throw std::out_of_range("no argument at index " + boost::lexical_cast<std::string>(index));
     }
-    return m_arguments.via.array.ptr[index].as<T>();
+    return argument_as<T>(m_arguments.via.array.ptr[index]);
+}
+
+template <typename T>
+inline void wamp_invocation_impl::get_argument(std::size_t index, T& value) const
+{
+    if (m_arguments.type != msgpack::type::ARRAY || m_arguments.via.array.size <= index) {
+        throw std::out_of_range("no argument at index " + boost::lexical_cast<std::string>(index));
+    }
+    convert_argument(m_arguments.via.array.ptr[index], value);
 }
 
 template <typename List>
@@ -100,73 +121,43 @@ inline void wamp_invocation_impl::get_each_argument(T&... args) const
 template <typename T>
 inline T wamp_invocation_impl::kw_argument(const std::string& key) const
 {
-    if (m_kw_arguments.type != msgpack::type::MAP) {
-        throw msgpack::type_error();
-    }
-    for (std::size_t i = 0; i < m_kw_arguments.via.map.size; ++i) {
-        const msgpack::object_kv& kv = m_kw_arguments.via.map.ptr[i];
-        if (kv.key.type == msgpack::type::STR && key.size() == kv.key.via.str.size
-                && key.compare(0, key.size(), kv.key.via.str.ptr, kv.key.via.str.size) == 0)
-        {
-            return kv.val.as<T>();
-        }
-    }
-    throw std::out_of_range(key + " keyword argument doesn't exist");
+    return kw_argument<T>(wamp_key(key));
 }
 
 template <typename T>
 inline T wamp_invocation_impl::kw_argument(const char* key) const
 {
-    if (m_kw_arguments.type != msgpack::type::MAP) {
-        throw msgpack::type_error();
-    }
-    std::size_t key_size = strlen(key);
-    for (std::size_t i = 0; i < m_kw_arguments.via.map.size; ++i) {
-        const msgpack::object_kv& kv = m_kw_arguments.via.map.ptr[i];
-        if (kv.key.type == msgpack::type::STR && key_size == kv.key.via.str.size
-                && memcmp(key, kv.key.via.str.ptr, key_size) == 0)
-        {
-            return kv.val.as<T>();
-        }
+    return kw_argument<T>(wamp_key(key, strlen(key)));
+}
+
+template <typename T>
+inline T wamp_invocation_impl::kw_argument(const wamp_key& key) const
+{
+    const msgpack::object* value = m_kw_arguments_index.find(m_kw_arguments, key);
+    if (!value) {
+        throw std::out_of_range(key.str() + " keyword argument doesn't exist");
     }
-    throw std::out_of_range(std::string(key) + " keyword argument doesn't exist");
+    return argument_as<T>(*value);
 }
 
 template <typename T>
 inline T wamp_invocation_impl::kw_argument_or(const std::string& key, const T& fallback) const
 {
-    if (m_kw_arguments.type != msgpack::type::MAP) {
-        throw msgpack::type_error();
-    }
-    for (std::size_t i = 0; i < m_kw_arguments.via.map.size; ++i) {
-        const msgpack::object_kv& kv = m_kw_arguments.via.map.ptr[i];
-        if (kv.key.type == msgpack::type::STR && key.size() == kv.key.via.str.size
-                && key.compare(0, key.size(), kv.key.via.str.ptr, kv.key.via.str.size) == 0)
-        {
-            return kv.val.as<T>();
-        }
-    }
-    return fallback;
+    return kw_argument_or<T>(wamp_key(key), fallback);
 }
 
 template <typename T>
 inline T wamp_invocation_impl::kw_argument_or(const char* key, const T& fallback) const
 {
-    if (m_kw_arguments.type != msgpack::type::MAP) {
-        throw msgpack::type_error();
-    }
-    std::size_t key_size = strlen(key);
-    for (std::size_t i = 0; i < m_kw_arguments.via.map.size; ++i) {
-        const msgpack::object_kv& kv = m_kw_arguments.via.map.ptr[i];
-        if (kv.key.type == msgpack::type::STR && key_size == kv.key.via.str.size
-                && memcmp(key, kv.key.via.str.ptr, key_size) == 0)
-        {
-            return kv.val.as<T>();
-        }
-    }
-    return fallback;
+    return kw_argument_or<T>(wamp_key(key, strlen(key)), fallback);
 }
 
+template <typename T>
+inline T wamp_invocation_impl::kw_argument_or(const wamp_key& key, const T& fallback) const
+{
+    const msgpack::object* value = m_kw_arguments_index.find(m_kw_arguments, key);
+    return value ? argument_as<T>(*value) : fallback;
+}
 
 template <typename Map>
 inline Map wamp_invocation_impl::kw_arguments() const
@@ -183,72 +174,44 @@ inline void wamp_invocation_impl::get_kw_arguments(Map& kw_args) const
 template <typename T>
 inline T wamp_invocation_impl::detail(const std::string& key) const
 {
-    if (m_details.type != msgpack::type::MAP) {
-        throw msgpack::type_error();
-    }
-    for (std::size_t i = 0; i < m_details.via.map.size; ++i) {
-        const msgpack::object_kv& kv = m_details.via.map.ptr[i];
-        if (kv.key.type == msgpack::type::STR && key.size() == kv.key.via.str.size
-            && key.compare(0, key.size(), kv.key.via.str.ptr, kv.key.via.str.size) == 0)
-        {
-            return kv.val.as<T>();
-        }
-    }
-    throw std::out_of_range(key + " call detail doesn't exist");
+    return detail<T>(wamp_key(key));
 }
 
 template <typename T>
 inline T wamp_invocation_impl::detail(const char* key) const
 {
-    if (m_details.type != msgpack::type::MAP) {
-        throw msgpack::type_error();
-    }
-    std::size_t key_size = strlen(key);
-    for (std::size_t i = 0; i < m_details.via.map.size; ++i) {
-        const msgpack::object_kv& kv = m_details.via.map.ptr[i];
-        if (kv.key.type == msgpack::type::STR && key_size == kv.key.via.str.size
-            && memcmp(key, kv.key.via.str.ptr, key_size) == 0)
-        {
-            return kv.val.as<T>();
-        }
+    return detail<T>(wamp_key(key, strlen(key)));
+}
+
+template <typename T>
+inline T wamp_invocation_impl::detail(const wamp_key& key) const
+{
+    const msgpack::object* value = m_details_index.find(m_details, key);
+    if (!value) {
+        throw std::out_of_range(key.str() + " call detail doesn't exist");
     }
-    throw std::out_of_range(std::string(key) + " call detail doesn't exist");
+    return argument_as<T>(*value);
 }
 
 template <typename T>
 inline T wamp_invocation_impl::detail_or(const std::string& key, const T& fallback) const
 {
-    if (m_details.type != msgpack::type::MAP) {
-        throw msgpack::type_error();
-    }
-    for (std::size_t i = 0; i < m_details.via.map.size; ++i) {
-        const msgpack::object_kv& kv = m_details.via.map.ptr[i];
-        if (kv.key.type == msgpack::type::STR && key.size() == kv.key.via.str.size
-            && key.compare(0, key.size(), kv.key.via.str.ptr, kv.key.via.str.size) == 0)
-        {
-            return kv.val.as<T>();
-        }
-    }
-    return fallback;
+    return detail_or<T>(wamp_key(key), fallback);
 }
 
 template <typename T>
 inline T wamp_invocation_impl::detail_or(const char* key, const T& fallback) const
 {
-    if (m_details.type != msgpack::type::MAP) {
-        throw msgpack::type_error();
-    }
-    std::size_t key_size = strlen(key);
-    for (std::size_t i = 0; i < m_details.via.map.size; ++i) {
-        const msgpack::object_kv& kv = m_details.via.map.ptr[i];
-        if (kv.key.type == msgpack::type::STR && key_size == kv.key.via.str.size
-            && memcmp(key, kv.key.via.str.ptr, key_size) == 0)
-        {
-            return kv.val.as<T>();
-        }
-    }
-    return fallback;
+    return detail_or<T>(wamp_key(key, strlen(key)), fallback);
+}
+
+template <typename T>
+inline T wamp_invocation_impl::detail_or(const wamp_key& key, const T& fallback) const
+{
+    const msgpack::object* value = m_details_index.find(m_details, key);
+    return value ? argument_as<T>(*value) : fallback;
 }
+
 template <typename Map>
 inline Map wamp_invocation_impl::details() const
 {
@@ -266,6 +229,45 @@ inline bool wamp_invocation_impl::progressive_results_expected() const
     return m_progressive_results_expected;
 }
 
+inline bool wamp_invocation_impl::canceled() const
+{
+    return m_canceled.load(std::memory_order_acquire);
+}
+
+inline wamp_cancel_mode wamp_invocation_impl::cancel_mode() const
+{
+    return m_cancel_mode;
+}
+
+inline void wamp_invocation_impl::on_cancel(std::function<void()> handler)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_cancel_mutex);
+        if (!m_canceled.load(std::memory_order_relaxed)) {
+            m_cancel_handler = std::move(handler);
+            return;
+        }
+    }
+
+    if (handler) {
+        handler();
+    }
+}
+
+inline bool wamp_invocation_impl::more_arguments_expected() const
+{
+    return m_more_arguments_expected.load(std::memory_order_acquire);
+}
+
+inline void wamp_invocation_impl::on_arguments(arguments_handler handler)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_arguments_mutex);
+        m_arguments_handler = std::move(handler);
+    }
+    deliver_arguments();
+}
+
 inline void wamp_invocation_impl::empty_result()
 {
     throw_if_not_sendable();
@@ -435,7 +437,9 @@ inline void wamp_invocation_impl::set_details(const msgpack::object& details)
 {
     m_uri = value_for_key_or<std::string>(details, "procedure", std::string());
     m_progressive_results_expected = value_for_key_or<bool>(details, "receive_progress", false);
+    m_more_arguments_expected = value_for_key_or<bool>(details, "progress", false);
     m_details = details;
+    m_details_index.reset();
 }
 
 inline void wamp_invocation_impl::set_request_id(std::uint64_t request_id)
@@ -456,6 +460,100 @@ inline void wamp_invocation_impl::set_arguments(const msgpack::object& arguments
 inline void wamp_invocation_impl::set_kw_arguments(const msgpack::object& kw_arguments)
 {
     m_kw_arguments = kw_arguments;
+    m_kw_arguments_index.reset();
+}
+
+inline void wamp_invocation_impl::interrupt(wamp_cancel_mode mode)
+{
+    std::function<void()> handler;
+    {
+        std::lock_guard<std::mutex> lock(m_cancel_mutex);
+        if (m_canceled.load(std::memory_order_relaxed)) {
+            return;
+        }
+        m_cancel_mode = mode;
+        m_canceled.store(true, std::memory_order_release);
+        handler = std::move(m_cancel_handler);
+        m_cancel_handler = nullptr;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_arguments_mutex);
+        m_pending_arguments.clear();
+        m_arguments_handler = nullptr;
+    }
+
+    if (handler) {
+        handler();
+    }
+}
+
+inline void wamp_invocation_impl::push_arguments(
+        msgpack::zone&& zone,
+        const msgpack::object& details,
+        const msgpack::object& arguments,
+        const msgpack::object& kw_arguments)
+{
+    bool overflow = false;
+    {
+        std::lock_guard<std::mutex> lock(m_arguments_mutex);
+        if (m_pending_arguments.size() < WAMP_INVOCATION_MAX_PENDING_CHUNKS) {
+            m_pending_arguments.push_back(arguments_chunk{
+                    wamp_call_result(std::move(zone)), value_for_key_or<bool>(details, "progress", false)});
+            arguments_chunk& chunk = m_pending_arguments.back();
+            chunk.arguments.set_arguments(arguments);
+            chunk.arguments.set_kw_arguments(kw_arguments);
+        } else {
+            // The procedure does not take its chunks; give up on the call
+            // rather than holding all of it in memory.
+            m_pending_arguments.clear();
+            m_arguments_handler = nullptr;
+            overflow = true;
+        }
+    }
+
+    if (overflow) {
+        if (sendable()) {
+            error("wamp.error.runtime_error", std::make_tuple(std::string("too many argument chunks pending")));
+        }
+        return;
+    }
+
+    deliver_arguments();
+}
+
+inline void wamp_invocation_impl::deliver_arguments()
+{
+    // Whoever delivers keeps going until no chunks are left, so that chunks pushed
+    // while a handler runs on another thread are passed on in order.
+    std::unique_lock<std::mutex> lock(m_arguments_mutex);
+    if (m_delivering_arguments || !m_arguments_handler) {
+        return;
+    }
+
+    m_delivering_arguments = true;
+    while (!m_pending_arguments.empty() && m_arguments_handler) {
+        arguments_chunk chunk = std::move(m_pending_arguments.front());
+        m_pending_arguments.pop_front();
+        arguments_handler handler = m_arguments_handler;
+        if (!chunk.more) {
+            m_arguments_handler = nullptr;
+        }
+        m_more_arguments_expected = chunk.more;
+        lock.unlock();
+
+        // The chunk is the handler's own; the invocation is left untouched.
+        try {
+            handler(shared_from_this(), std::move(chunk.arguments));
+        } catch (...) {
+            if (sendable()) {
+                error("wamp.error.runtime_error");
+            }
+        }
+
+        lock.lock();
+    }
+    m_delivering_arguments = false;
 }
 
 inline bool wamp_invocation_impl::sendable() const
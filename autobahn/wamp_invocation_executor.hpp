@@ -0,0 +1,64 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Crossbar.io Technologies GmbH and contributors
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef AUTOBAHN_WAMP_INVOCATION_EXECUTOR_HPP
+#define AUTOBAHN_WAMP_INVOCATION_EXECUTOR_HPP
+
+#include "wamp_invocation.hpp"
+
+#include <functional>
+
+namespace autobahn {
+
+/*!
+ * Runs procedure invocations off the session, see
+ * wamp_session::set_invocation_pool() and wamp_session::provide().
+ */
+class wamp_invocation_executor
+{
+public:
+    /*!
+     * Queue the work of running an invocation.
+     *
+     * @param invocation The invocation about to run, e.g. to read scheduling hints from.
+     * @param work Runs the procedure; exceptions are turned into error replies already.
+     */
+    virtual void post(const wamp_invocation& invocation, std::function<void()>&& work) = 0;
+
+    /*!
+     * Default virtual destructor.
+     */
+    virtual ~wamp_invocation_executor() = default;
+};
+
+} // namespace autobahn
+
+#endif // AUTOBAHN_WAMP_INVOCATION_EXECUTOR_HPP
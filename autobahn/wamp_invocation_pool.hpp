@@ -0,0 +1,132 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Crossbar.io Technologies GmbH and contributors
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef AUTOBAHN_WAMP_INVOCATION_POOL_HPP
+#define AUTOBAHN_WAMP_INVOCATION_POOL_HPP
+
+#include "wamp_invocation_executor.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace autobahn {
+
+/*!
+ * A work-stealing thread pool running procedure invocations off the
+ * session's io_service, see wamp_session::set_invocation_pool().
+ *
+ * Every worker has its own queue. Tasks posted from outside the pool are
+ * spread over the workers round robin, tasks posted from a worker go to
+ * its own queue. A worker runs its own queue oldest first and, when that
+ * is empty, steals the newest task of another worker.
+ */
+class wamp_invocation_pool : public wamp_invocation_executor
+{
+public:
+    using task = std::function<void()>;
+
+    /*!
+     * Starts the pool.
+     *
+     * \param threads The number of worker threads; zero uses the number of
+     *                hardware threads.
+     */
+    explicit wamp_invocation_pool(std::size_t threads = 0);
+
+    /// Stops the pool, running the tasks still queued first. Must not run on a worker.
+    virtual ~wamp_invocation_pool() override;
+
+    wamp_invocation_pool(const wamp_invocation_pool&) = delete;
+    wamp_invocation_pool& operator=(const wamp_invocation_pool&) = delete;
+
+    /// Queue a task. Exceptions escaping the task are swallowed.
+    void post(task&& work);
+
+    /*!
+     * @copydoc wamp_invocation_executor::post()
+     */
+    virtual void post(const wamp_invocation& invocation, task&& work) override;
+
+    /// Run the queued tasks and join the workers. Tasks posted later are never run.
+    void stop();
+
+    /// The number of worker threads.
+    std::size_t threads() const;
+
+    /// The number of tasks queued but not yet started.
+    std::size_t queue_depth() const;
+
+    /// The number of tasks a worker took from the queue of another worker.
+    uint64_t steals() const;
+
+    /// The number of tasks run so far.
+    uint64_t executed() const;
+
+private:
+    struct worker
+    {
+        std::mutex m_mutex;
+        std::deque<task> m_tasks;
+    };
+
+    void run(std::size_t index);
+    bool take(std::size_t index, task& work);
+
+    // The pool and index of the worker running on the calling thread, if any.
+    static const wamp_invocation_pool*& current_pool();
+    static std::size_t& current_index();
+
+    std::vector<std::unique_ptr<worker>> m_workers;
+    std::vector<std::thread> m_threads;
+
+    std::mutex m_wake_mutex;
+    std::condition_variable m_wake;
+    bool m_stopped;
+
+    std::atomic<std::size_t> m_next_worker;
+    std::atomic<std::size_t> m_queue_depth;
+    std::atomic<uint64_t> m_steals;
+    std::atomic<uint64_t> m_executed;
+};
+
+} // namespace autobahn
+
+#include "wamp_invocation_pool.ipp"
+
+#endif // AUTOBAHN_WAMP_INVOCATION_POOL_HPP
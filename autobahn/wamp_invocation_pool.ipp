@@ -0,0 +1,190 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Crossbar.io Technologies GmbH and contributors
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include <algorithm>
+
+namespace autobahn {
+
+inline wamp_invocation_pool::wamp_invocation_pool(std::size_t threads)
+    : m_workers()
+    , m_threads()
+    , m_wake_mutex()
+    , m_wake()
+    , m_stopped(false)
+    , m_next_worker(0)
+    , m_queue_depth(0)
+    , m_steals(0)
+    , m_executed(0)
+{
+    if (threads == 0) {
+        threads = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+    }
+
+    for (std::size_t index = 0; index < threads; ++index) {
+        m_workers.emplace_back(new worker());
+    }
+    for (std::size_t index = 0; index < threads; ++index) {
+        m_threads.emplace_back(&wamp_invocation_pool::run, this, index);
+    }
+}
+
+inline wamp_invocation_pool::~wamp_invocation_pool()
+{
+    stop();
+}
+
+inline void wamp_invocation_pool::post(task&& work)
+{
+    std::size_t index = current_pool() == this
+            ? current_index()
+            : m_next_worker.fetch_add(1, std::memory_order_relaxed) % m_workers.size();
+
+    {
+        // Counted under the worker's lock, before anyone can take the task and
+        // count it out again, so the depth never drops below zero.
+        std::lock_guard<std::mutex> lock(m_workers[index]->m_mutex);
+        m_queue_depth.fetch_add(1);
+        m_workers[index]->m_tasks.push_back(std::move(work));
+    }
+
+    // Taking the lock orders the new depth against a worker about to sleep.
+    std::lock_guard<std::mutex> lock(m_wake_mutex);
+    m_wake.notify_one();
+}
+
+inline void wamp_invocation_pool::post(const wamp_invocation& /*invocation*/, task&& work)
+{
+    post(std::move(work));
+}
+
+inline void wamp_invocation_pool::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_wake_mutex);
+        if (m_stopped) {
+            return;
+        }
+        m_stopped = true;
+    }
+    m_wake.notify_all();
+
+    for (auto& thread : m_threads) {
+        thread.join();
+    }
+}
+
+inline std::size_t wamp_invocation_pool::threads() const
+{
+    return m_workers.size();
+}
+
+inline std::size_t wamp_invocation_pool::queue_depth() const
+{
+    return m_queue_depth.load(std::memory_order_relaxed);
+}
+
+inline uint64_t wamp_invocation_pool::steals() const
+{
+    return m_steals.load(std::memory_order_relaxed);
+}
+
+inline uint64_t wamp_invocation_pool::executed() const
+{
+    return m_executed.load(std::memory_order_relaxed);
+}
+
+inline void wamp_invocation_pool::run(std::size_t index)
+{
+    current_pool() = this;
+    current_index() = index;
+
+    for (;;) {
+        task work;
+        if (take(index, work)) {
+            try {
+                work();
+            } catch (...) {
+            }
+            m_executed.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_wake_mutex);
+        m_wake.wait(lock, [this]() {
+            return m_stopped || m_queue_depth.load() > 0;
+        });
+        if (m_stopped && m_queue_depth.load() == 0) {
+            return;
+        }
+    }
+}
+
+inline bool wamp_invocation_pool::take(std::size_t index, task& work)
+{
+    {
+        worker& own = *m_workers[index];
+        std::lock_guard<std::mutex> lock(own.m_mutex);
+        if (!own.m_tasks.empty()) {
+            work = std::move(own.m_tasks.front());
+            own.m_tasks.pop_front();
+            m_queue_depth.fetch_sub(1);
+            return true;
+        }
+    }
+
+    for (std::size_t offset = 1; offset < m_workers.size(); ++offset) {
+        worker& victim = *m_workers[(index + offset) % m_workers.size()];
+        std::lock_guard<std::mutex> lock(victim.m_mutex);
+        if (!victim.m_tasks.empty()) {
+            work = std::move(victim.m_tasks.back());
+            victim.m_tasks.pop_back();
+            m_queue_depth.fetch_sub(1);
+            m_steals.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+inline const wamp_invocation_pool*& wamp_invocation_pool::current_pool()
+{
+    static thread_local const wamp_invocation_pool* pool = nullptr;
+    return pool;
+}
+
+inline std::size_t& wamp_invocation_pool::current_index()
+{
+    static thread_local std::size_t index = 0;
+    return index;
+}
+
+} // namespace autobahn
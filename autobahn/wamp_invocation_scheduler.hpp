@@ -0,0 +1,183 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Crossbar.io Technologies GmbH and contributors
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef AUTOBAHN_WAMP_INVOCATION_SCHEDULER_HPP
+#define AUTOBAHN_WAMP_INVOCATION_SCHEDULER_HPP
+
+#include "wamp_invocation_executor.hpp"
+#include "wamp_invocation_pool.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace autobahn {
+
+/*!
+ * Queue latency counters of one priority class of a wamp_invocation_scheduler.
+ */
+class wamp_priority_class_metrics
+{
+public:
+    /// Queue latencies are counted in power of two microsecond buckets: <2us, <4us, ..., the last one open ended.
+    static const std::size_t NUM_LATENCY_BUCKETS = 16;
+    using latency_histogram = std::array<uint64_t, NUM_LATENCY_BUCKETS>;
+
+    wamp_priority_class_metrics();
+
+    const std::string& name() const;
+    unsigned priority() const;
+
+    /// The queue latency objective of the class.
+    const std::chrono::microseconds& latency_slo() const;
+
+    /// Invocations started so far.
+    uint64_t started() const;
+
+    /// Invocations that waited longer than the latency objective.
+    uint64_t slo_violations() const;
+
+    /// The longest time an invocation waited.
+    const std::chrono::microseconds& max_latency() const;
+
+    /// Invocations waiting when the metrics were taken.
+    std::size_t queue_length() const;
+
+    /// Number of started invocations by the time they waited.
+    const latency_histogram& latencies() const;
+
+    //
+    // functions only called internally by wamp_invocation_scheduler
+
+    void set_class(const std::string& name, unsigned priority, const std::chrono::microseconds& latency_slo);
+    void record_start(const std::chrono::microseconds& latency);
+    void set_queue_length(std::size_t queue_length);
+
+private:
+    std::string m_name;
+    unsigned m_priority;
+    std::chrono::microseconds m_latency_slo;
+    uint64_t m_started;
+    uint64_t m_slo_violations;
+    std::chrono::microseconds m_max_latency;
+    std::size_t m_queue_length;
+    latency_histogram m_latencies;
+};
+
+/*!
+ * Orders invocations of different registrations by priority before they run
+ * on a wamp_invocation_pool.
+ *
+ * Registrations are assigned to priority classes; lower priority values run
+ * first. To keep low priority classes from starving, every aging interval an
+ * invocation waits counts as one level of priority gained. Within a class
+ * invocations run in arrival order.
+ *
+ * Each queued invocation posts one task to the pool, which runs the most
+ * urgent invocation at the time it starts, so the pool's own ordering does
+ * not matter.
+ */
+class wamp_invocation_scheduler :
+        public std::enable_shared_from_this<wamp_invocation_scheduler>
+{
+public:
+    /*!
+     * \param pool The pool running the invocations.
+     * \param aging How long an invocation waits to gain one priority level.
+     */
+    explicit wamp_invocation_scheduler(
+            const std::shared_ptr<wamp_invocation_pool>& pool,
+            const std::chrono::microseconds& aging = std::chrono::milliseconds(10));
+
+    wamp_invocation_scheduler(const wamp_invocation_scheduler&) = delete;
+    wamp_invocation_scheduler& operator=(const wamp_invocation_scheduler&) = delete;
+
+    /*!
+     * Adds a priority class. The returned executor queues invocations in
+     * this class; pass it to wamp_session::provide().
+     *
+     * \param name The name of the class, also used for priority hints.
+     * \param priority The priority of the class; lower values run first.
+     * \param latency_slo The queue latency objective, observable in the metrics.
+     */
+    std::shared_ptr<wamp_invocation_executor> add_class(
+            const std::string& name,
+            unsigned priority,
+            const std::chrono::microseconds& latency_slo);
+
+    /*!
+     * Let callers pick the class: an invocation whose details carry the name
+     * of a class under @p key is queued in that class instead. Empty, the
+     * default, ignores hints.
+     */
+    void set_priority_hint_key(const std::string& key);
+
+    /// Snapshots of the counters of every class, in the order they were added.
+    std::vector<wamp_priority_class_metrics> metrics() const;
+
+private:
+    class priority_class_executor;
+
+    struct queued_invocation
+    {
+        std::chrono::steady_clock::time_point m_enqueued;
+        std::function<void()> m_work;
+    };
+
+    struct priority_class
+    {
+        std::deque<queued_invocation> m_queue;
+        wamp_priority_class_metrics m_metrics;
+    };
+
+    void post(std::size_t index, const wamp_invocation& invocation, std::function<void()>&& work);
+    void run_next();
+
+    std::shared_ptr<wamp_invocation_pool> m_pool;
+    std::chrono::microseconds m_aging;
+
+    mutable std::mutex m_mutex;
+    std::string m_priority_hint_key;
+    std::vector<priority_class> m_classes;
+};
+
+} // namespace autobahn
+
+#include "wamp_invocation_scheduler.ipp"
+
+#endif // AUTOBAHN_WAMP_INVOCATION_SCHEDULER_HPP
@@ -0,0 +1,263 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Crossbar.io Technologies GmbH and contributors
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+namespace autobahn {
+
+inline wamp_priority_class_metrics::wamp_priority_class_metrics()
+    : m_name()
+    , m_priority(0)
+    , m_latency_slo(0)
+    , m_started(0)
+    , m_slo_violations(0)
+    , m_max_latency(0)
+    , m_queue_length(0)
+    , m_latencies()
+{
+}
+
+inline const std::string& wamp_priority_class_metrics::name() const
+{
+    return m_name;
+}
+
+inline unsigned wamp_priority_class_metrics::priority() const
+{
+    return m_priority;
+}
+
+inline const std::chrono::microseconds& wamp_priority_class_metrics::latency_slo() const
+{
+    return m_latency_slo;
+}
+
+inline uint64_t wamp_priority_class_metrics::started() const
+{
+    return m_started;
+}
+
+inline uint64_t wamp_priority_class_metrics::slo_violations() const
+{
+    return m_slo_violations;
+}
+
+inline const std::chrono::microseconds& wamp_priority_class_metrics::max_latency() const
+{
+    return m_max_latency;
+}
+
+inline std::size_t wamp_priority_class_metrics::queue_length() const
+{
+    return m_queue_length;
+}
+
+inline const wamp_priority_class_metrics::latency_histogram& wamp_priority_class_metrics::latencies() const
+{
+    return m_latencies;
+}
+
+inline void wamp_priority_class_metrics::set_class(
+        const std::string& name, unsigned priority, const std::chrono::microseconds& latency_slo)
+{
+    m_name = name;
+    m_priority = priority;
+    m_latency_slo = latency_slo;
+}
+
+inline void wamp_priority_class_metrics::record_start(const std::chrono::microseconds& latency)
+{
+    ++m_started;
+    if (latency > m_latency_slo) {
+        ++m_slo_violations;
+    }
+    if (latency > m_max_latency) {
+        m_max_latency = latency;
+    }
+
+    uint64_t micros = latency.count() > 0 ? static_cast<uint64_t>(latency.count()) : 0;
+    std::size_t bucket = 0;
+    while (micros > 1 && bucket + 1 < NUM_LATENCY_BUCKETS) {
+        micros >>= 1;
+        ++bucket;
+    }
+    ++m_latencies[bucket];
+}
+
+inline void wamp_priority_class_metrics::set_queue_length(std::size_t queue_length)
+{
+    m_queue_length = queue_length;
+}
+
+/// Queues the invocations of the registrations it was provided with in one class.
+class wamp_invocation_scheduler::priority_class_executor : public wamp_invocation_executor
+{
+public:
+    priority_class_executor(const std::shared_ptr<wamp_invocation_scheduler>& scheduler, std::size_t index)
+        : m_scheduler(scheduler)
+        , m_index(index)
+    {
+    }
+
+    virtual void post(const wamp_invocation& invocation, std::function<void()>&& work) override
+    {
+        m_scheduler->post(m_index, invocation, std::move(work));
+    }
+
+private:
+    std::shared_ptr<wamp_invocation_scheduler> m_scheduler;
+    std::size_t m_index;
+};
+
+inline wamp_invocation_scheduler::wamp_invocation_scheduler(
+        const std::shared_ptr<wamp_invocation_pool>& pool,
+        const std::chrono::microseconds& aging)
+    : m_pool(pool)
+    , m_aging(aging)
+    , m_mutex()
+    , m_priority_hint_key()
+    , m_classes()
+{
+}
+
+inline std::shared_ptr<wamp_invocation_executor> wamp_invocation_scheduler::add_class(
+        const std::string& name,
+        unsigned priority,
+        const std::chrono::microseconds& latency_slo)
+{
+    std::size_t index = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        index = m_classes.size();
+        m_classes.emplace_back();
+        m_classes.back().m_metrics.set_class(name, priority, latency_slo);
+    }
+
+    return std::make_shared<priority_class_executor>(shared_from_this(), index);
+}
+
+inline void wamp_invocation_scheduler::set_priority_hint_key(const std::string& key)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_priority_hint_key = key;
+}
+
+inline std::vector<wamp_priority_class_metrics> wamp_invocation_scheduler::metrics() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    std::vector<wamp_priority_class_metrics> metrics;
+    metrics.reserve(m_classes.size());
+    for (const auto& priority_class : m_classes) {
+        metrics.push_back(priority_class.m_metrics);
+        metrics.back().set_queue_length(priority_class.m_queue.size());
+    }
+    return metrics;
+}
+
+inline void wamp_invocation_scheduler::post(
+        std::size_t index, const wamp_invocation& invocation, std::function<void()>&& work)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (!m_priority_hint_key.empty()) {
+            std::string hint;
+            try {
+                hint = invocation->detail_or<std::string>(m_priority_hint_key, std::string());
+            } catch (const std::exception&) {
+                // Hints that are not class names are ignored.
+            }
+            for (std::size_t hinted = 0; !hint.empty() && hinted < m_classes.size(); ++hinted) {
+                if (m_classes[hinted].m_metrics.name() == hint) {
+                    index = hinted;
+                    break;
+                }
+            }
+        }
+
+        m_classes[index].m_queue.push_back(
+                queued_invocation{std::chrono::steady_clock::now(), std::move(work)});
+    }
+
+    // Tasks only hold the scheduler weakly, the pool must not keep it alive.
+    std::weak_ptr<wamp_invocation_scheduler> weak_self = shared_from_this();
+    m_pool->post([weak_self]() {
+        auto shared_self = weak_self.lock();
+        if (shared_self) {
+            shared_self->run_next();
+        }
+    });
+}
+
+inline void wamp_invocation_scheduler::run_next()
+{
+    std::function<void()> work;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        const auto now = std::chrono::steady_clock::now();
+        const int64_t aging = m_aging.count();
+
+        // Lowest rank first: the class priority in aging intervals, less the
+        // time the oldest invocation of the class has waited.
+        priority_class* next = nullptr;
+        int64_t next_rank = std::numeric_limits<int64_t>::max();
+        for (auto& priority_class : m_classes) {
+            if (priority_class.m_queue.empty()) {
+                continue;
+            }
+
+            int64_t waited = std::chrono::duration_cast<std::chrono::microseconds>(
+                    now - priority_class.m_queue.front().m_enqueued).count();
+            int64_t rank = static_cast<int64_t>(priority_class.m_metrics.priority()) * aging - waited;
+            if (rank < next_rank) {
+                next = &priority_class;
+                next_rank = rank;
+            }
+        }
+        if (!next) {
+            return;
+        }
+
+        queued_invocation queued = std::move(next->m_queue.front());
+        next->m_queue.pop_front();
+        next->m_metrics.record_start(
+                std::chrono::duration_cast<std::chrono::microseconds>(now - queued.m_enqueued));
+        work = std::move(queued.m_work);
+    }
+
+    work();
+}
+
+} // namespace autobahn
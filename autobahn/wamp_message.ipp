@@ -113,6 +113,11 @@ inline std::size_t wamp_message::size() const
     return m_fields.size();
 }
 
+inline const wamp_message::message_fields& wamp_message::fields() const
+{
+    return m_fields;
+}
+
 inline wamp_message::message_fields&& wamp_message::fields()
 {
     return std::move(m_fields);
@@ -0,0 +1,144 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Crossbar.io Technologies GmbH and contributors
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef AUTOBAHN_WAMP_PROGRESSIVE_CALL_HPP
+#define AUTOBAHN_WAMP_PROGRESSIVE_CALL_HPP
+
+#include "wamp_call_options.hpp"
+#include "wamp_call_result.hpp"
+#include "boost_config.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace autobahn {
+
+class wamp_message;
+
+/*!
+ * A call whose arguments are sent in chunks (progressive call invocations),
+ * opened with wamp_session::open_call().
+ *
+ * Each chunk is sent as a CALL with the same request id and reaches the callee
+ * as a further INVOCATION on the same wamp_invocation, so neither end has to
+ * hold the whole payload at once.
+ *
+ * Example:
+ * ```
+ * auto upload = session->open_call("com.example.upload");
+ * for (const auto& block : blocks) {
+ *     upload.progress(std::make_tuple(block));
+ * }
+ * boost::future<autobahn::wamp_call_result> result = upload.finish();
+ * ```
+ */
+class wamp_progressive_call
+{
+public:
+    wamp_progressive_call();
+    wamp_progressive_call(wamp_progressive_call&& other);
+    wamp_progressive_call& operator=(wamp_progressive_call&& other);
+
+    /*!
+     * Finishes the call without further arguments if it is still open.
+     */
+    ~wamp_progressive_call();
+
+    /*!
+     * Sends a chunk of positional arguments, more chunks are to follow.
+     */
+    template <typename List>
+    void progress(const List& arguments);
+
+    /*!
+     * Sends a chunk of positional and keyword arguments, more chunks are to follow.
+     */
+    template <typename List, typename Map>
+    void progress(const List& arguments, const Map& kw_arguments);
+
+    /*!
+     * Finishes the call without sending further arguments.
+     *
+     * \return A future that resolves to the result of the remote procedure call.
+     */
+    boost::future<wamp_call_result> finish();
+
+    /*!
+     * Finishes the call with a last chunk of positional arguments.
+     */
+    template <typename List>
+    boost::future<wamp_call_result> finish(const List& arguments);
+
+    /*!
+     * Finishes the call with a last chunk of positional and keyword arguments.
+     */
+    template <typename List, typename Map>
+    boost::future<wamp_call_result> finish(const List& arguments, const Map& kw_arguments);
+
+    /*!
+     * Whether chunks can still be sent, i.e. the call was opened and is not finished yet.
+     */
+    bool sendable() const;
+
+    //
+    // functions only called internally by wamp_session
+
+    using send_chunk_fn = std::function<void(const std::shared_ptr<wamp_message>&, bool first)>;
+    wamp_progressive_call(
+            const std::string& procedure,
+            const wamp_call_options& options,
+            uint64_t request_id,
+            send_chunk_fn&& send_chunk,
+            boost::future<wamp_call_result>&& result);
+
+private:
+    void throw_if_not_sendable() const;
+    std::shared_ptr<wamp_message> make_chunk(std::size_t num_fields, bool progress) const;
+    void send_chunk(const std::shared_ptr<wamp_message>& chunk);
+
+private:
+    std::string m_procedure;
+    std::chrono::milliseconds m_timeout;
+    bool m_receive_progress;
+    uint64_t m_request_id;
+    send_chunk_fn m_send_chunk_fn;
+    bool m_first_sent;
+    boost::future<wamp_call_result> m_result;
+};
+
+} // namespace autobahn
+
+#include "wamp_progressive_call.ipp"
+
+#endif // AUTOBAHN_WAMP_PROGRESSIVE_CALL_HPP
@@ -0,0 +1,213 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Crossbar.io Technologies GmbH and contributors
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include "wamp_message.hpp"
+#include "wamp_message_type.hpp"
+
+#include <msgpack.hpp>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+
+namespace autobahn {
+
+inline wamp_progressive_call::wamp_progressive_call()
+    : m_procedure()
+    , m_timeout()
+    , m_receive_progress(false)
+    , m_request_id(0)
+    , m_send_chunk_fn()
+    , m_first_sent(false)
+    , m_result()
+{
+}
+
+inline wamp_progressive_call::wamp_progressive_call(
+        const std::string& procedure,
+        const wamp_call_options& options,
+        uint64_t request_id,
+        send_chunk_fn&& send_chunk,
+        boost::future<wamp_call_result>&& result)
+    : m_procedure(procedure)
+    , m_timeout(options.timeout())
+    , m_receive_progress(static_cast<bool>(options.progress_handler()))
+    , m_request_id(request_id)
+    , m_send_chunk_fn(std::move(send_chunk))
+    , m_first_sent(false)
+    , m_result(std::move(result))
+{
+}
+
+inline wamp_progressive_call::wamp_progressive_call(wamp_progressive_call&& other)
+    : m_procedure(std::move(other.m_procedure))
+    , m_timeout(other.m_timeout)
+    , m_receive_progress(other.m_receive_progress)
+    , m_request_id(other.m_request_id)
+    , m_send_chunk_fn(std::move(other.m_send_chunk_fn))
+    , m_first_sent(other.m_first_sent)
+    , m_result(std::move(other.m_result))
+{
+    other.m_send_chunk_fn = send_chunk_fn();
+}
+
+inline wamp_progressive_call& wamp_progressive_call::operator=(wamp_progressive_call&& other)
+{
+    if (this != &other) {
+        if (sendable()) {
+            finish();
+        }
+        m_procedure = std::move(other.m_procedure);
+        m_timeout = other.m_timeout;
+        m_receive_progress = other.m_receive_progress;
+        m_request_id = other.m_request_id;
+        m_send_chunk_fn = std::move(other.m_send_chunk_fn);
+        m_first_sent = other.m_first_sent;
+        m_result = std::move(other.m_result);
+        other.m_send_chunk_fn = send_chunk_fn();
+    }
+    return *this;
+}
+
+inline wamp_progressive_call::~wamp_progressive_call()
+{
+    if (sendable()) {
+        try {
+            finish();
+        } catch (...) {
+        }
+    }
+}
+
+template <typename List>
+inline void wamp_progressive_call::progress(const List& arguments)
+{
+    throw_if_not_sendable();
+
+    // [CALL, Request|id, Options|dict, Procedure|uri, Arguments|list]
+    auto chunk = make_chunk(5, true);
+    chunk->set_field(4, arguments);
+    send_chunk(chunk);
+}
+
+template <typename List, typename Map>
+inline void wamp_progressive_call::progress(const List& arguments, const Map& kw_arguments)
+{
+    throw_if_not_sendable();
+
+    // [CALL, Request|id, Options|dict, Procedure|uri, Arguments|list, ArgumentsKw|dict]
+    auto chunk = make_chunk(6, true);
+    chunk->set_field(4, arguments);
+    chunk->set_field(5, kw_arguments);
+    send_chunk(chunk);
+}
+
+inline boost::future<wamp_call_result> wamp_progressive_call::finish()
+{
+    throw_if_not_sendable();
+
+    // [CALL, Request|id, Options|dict, Procedure|uri]
+    send_chunk(make_chunk(4, false));
+    m_send_chunk_fn = send_chunk_fn();
+
+    return std::move(m_result);
+}
+
+template <typename List>
+inline boost::future<wamp_call_result> wamp_progressive_call::finish(const List& arguments)
+{
+    throw_if_not_sendable();
+
+    auto chunk = make_chunk(5, false);
+    chunk->set_field(4, arguments);
+    send_chunk(chunk);
+    m_send_chunk_fn = send_chunk_fn();
+
+    return std::move(m_result);
+}
+
+template <typename List, typename Map>
+inline boost::future<wamp_call_result> wamp_progressive_call::finish(
+        const List& arguments, const Map& kw_arguments)
+{
+    throw_if_not_sendable();
+
+    auto chunk = make_chunk(6, false);
+    chunk->set_field(4, arguments);
+    chunk->set_field(5, kw_arguments);
+    send_chunk(chunk);
+    m_send_chunk_fn = send_chunk_fn();
+
+    return std::move(m_result);
+}
+
+inline bool wamp_progressive_call::sendable() const
+{
+    return static_cast<bool>(m_send_chunk_fn);
+}
+
+inline void wamp_progressive_call::throw_if_not_sendable() const
+{
+    if (!sendable()) {
+        throw std::runtime_error("tried to send arguments but wamp_progressive_call "
+                "is not sendable (already finished?)");
+    }
+}
+
+inline std::shared_ptr<wamp_message> wamp_progressive_call::make_chunk(std::size_t num_fields, bool progress) const
+{
+    std::unordered_map<std::string, msgpack::object> options;
+    if (m_timeout.count() > 0) {
+        options["timeout"] = msgpack::object(m_timeout.count());
+    }
+    if (m_receive_progress) {
+        options["receive_progress"] = msgpack::object(true);
+    }
+    if (progress) {
+        options["progress"] = msgpack::object(true);
+    }
+
+    auto chunk = std::make_shared<wamp_message>(num_fields);
+    chunk->set_field(0, static_cast<int>(message_type::CALL));
+    chunk->set_field(1, m_request_id);
+    chunk->set_field(2, options);
+    chunk->set_field(3, m_procedure);
+
+    return chunk;
+}
+
+inline void wamp_progressive_call::send_chunk(const std::shared_ptr<wamp_message>& chunk)
+{
+    bool first = !m_first_sent;
+    m_first_sent = true;
+    m_send_chunk_fn(chunk, first);
+}
+
+} // namespace autobahn
@@ -54,8 +54,19 @@ public:
 
     void set_exclude_me(const bool& exclude_me);
 
+    const bool& acknowledge() const;
+
+    /*!
+     * Asks the broker to acknowledge the publication. The publish future or
+     * completion handler then completes once the broker has accepted the
+     * publication, or fails with the broker's error, instead of completing
+     * as soon as the event has been sent.
+     */
+    void set_acknowledge(const bool& acknowledge);
+
 private:
     bool m_exclude_me;
+    bool m_acknowledge;
 };
 
 } // namespace autobahn
@@ -36,6 +36,7 @@ namespace autobahn {
 
 inline wamp_publish_options::wamp_publish_options()
     : m_exclude_me(true) //default
+    , m_acknowledge(false)
 {
 }
 
@@ -49,6 +50,16 @@ inline void wamp_publish_options::set_exclude_me(const bool& exclude_me)
     m_exclude_me = exclude_me;
 }
 
+inline const bool& wamp_publish_options::acknowledge() const
+{
+    return m_acknowledge;
+}
+
+inline void wamp_publish_options::set_acknowledge(const bool& acknowledge)
+{
+    m_acknowledge = acknowledge;
+}
+
 } // namespace autobahn
 
 namespace msgpack {
@@ -70,6 +81,11 @@ struct convert<autobahn::wamp_publish_options>
             options.set_exclude_me( options_map_itr->second.as<bool>());
         }
 
+        const auto acknowledge_itr = options_map.find("acknowledge");
+        if (acknowledge_itr != options_map.end()) {
+            options.set_acknowledge(acknowledge_itr->second.as<bool>());
+        }
+
         return object;
     }
 };
@@ -82,11 +98,14 @@ struct pack<autobahn::wamp_publish_options>
             msgpack::packer<Stream>& packer,
             autobahn::wamp_publish_options const& options) const
     {
-        std::unordered_map<std::string, unsigned> options_map;
+        std::unordered_map<std::string, bool> options_map;
         const auto& exclude_me = options.exclude_me();
         if (exclude_me != true) { //true is default, only false msut be transfered
             options_map["exclude_me"] = exclude_me;
         }
+        if (options.acknowledge()) {
+            options_map["acknowledge"] = true;
+        }
 
         packer.pack(options_map);
 
@@ -107,6 +126,9 @@ struct object_with_zone<autobahn::wamp_publish_options>
         if (exclude_me != true) { //true is default, only false must be transfered
             options_map["exclude_me"] = msgpack::object(exclude_me);
         }
+        if (options.acknowledge()) {
+            options_map["acknowledge"] = msgpack::object(true);
+        }
 
         object << options_map;
     }
@@ -0,0 +1,67 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Crossbar.io Technologies GmbH and contributors
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef AUTOBAHN_WAMP_PUBLISH_REQUEST_HPP
+#define AUTOBAHN_WAMP_PUBLISH_REQUEST_HPP
+
+#include "wamp_completion.hpp"
+#include "wamp_publication.hpp"
+
+#include <exception>
+
+namespace autobahn {
+
+/// An outstanding acknowledged publication.
+class wamp_publish_request
+{
+public:
+    using completion_type = wamp_completion<void(std::exception_ptr, wamp_publication)>;
+    using unidentified_completion_type = wamp_completion<void(std::exception_ptr)>;
+
+    wamp_publish_request();
+    explicit wamp_publish_request(completion_type&& completion);
+
+    /// For publications whose completion does not receive the publication id.
+    explicit wamp_publish_request(unidentified_completion_type&& completion);
+
+    void set_response(const wamp_publication& publication);
+    void set_exception(std::exception_ptr exception);
+
+private:
+    completion_type m_completion;
+    unidentified_completion_type m_unidentified_completion;
+};
+
+} // namespace autobahn
+
+#include "wamp_publish_request.ipp"
+
+#endif // AUTOBAHN_WAMP_PUBLISH_REQUEST_HPP
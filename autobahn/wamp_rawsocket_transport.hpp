@@ -35,6 +35,7 @@
 #include "wamp_transport.hpp"
 
 #include <boost/asio/io_service.hpp>
+#include <boost/asio/io_service_strand.hpp>
 #include <cstddef>
 #include <memory>
 #include <msgpack/unpack.hpp>
@@ -107,6 +108,14 @@ public:
      */
     virtual void send_message(wamp_message&& message) override;
 
+    /*!
+     * @copydoc wamp_transport::send_messages()
+     *
+     * The messages are serialized back to back, each with its length prefix,
+     * and written with a single write.
+     */
+    virtual void send_messages(std::vector<wamp_message>&& messages) override;
+
     /*!
      * @copydoc wamp_transport::set_pause_handler()
      */
@@ -174,6 +183,12 @@ private:
      */
     socket_type m_socket;
 
+    /*!
+     * Serializes the completion handlers of the socket operations, so the
+     * io service may be run on several threads.
+     */
+    boost::asio::io_service::strand m_strand;
+
     /*!
      * The remote endpoint to connect the socket to.
      */
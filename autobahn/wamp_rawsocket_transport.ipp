@@ -36,6 +36,7 @@
 #include <boost/asio/placeholders.hpp>
 #include <boost/asio/read.hpp>
 #include <boost/asio/write.hpp>
+#include <cstring>
 #include <system_error>
 
 namespace autobahn {
@@ -47,6 +48,7 @@ wamp_rawsocket_transport<Socket>::wamp_rawsocket_transport(
             bool debug_enabled)
     : wamp_transport()
     , m_socket(io_service)
+    , m_strand(io_service)
     , m_remote_endpoint(remote_endpoint)
     , m_connect()
     , m_disconnect()
@@ -111,13 +113,13 @@ boost::future<void> wamp_rawsocket_transport<Socket>::connect()
             boost::asio::async_read(
                     m_socket,
                     boost::asio::buffer(m_handshake_buffer, sizeof(m_handshake_buffer)),
-                    handshake_reply);
+                    m_strand.wrap(handshake_reply));
         } catch (const std::exception& e) {
             m_connect.set_exception(boost::copy_exception(e));
         }
     };
 
-    m_socket.async_connect(m_remote_endpoint, connect_handler);
+    m_socket.async_connect(m_remote_endpoint, m_strand.wrap(connect_handler));
 
     return m_connect.get_future();
 }
@@ -161,6 +163,34 @@ void wamp_rawsocket_transport<Socket>::send_message(wamp_message&& message)
     }
 }
 
+template <class Socket>
+void wamp_rawsocket_transport<Socket>::send_messages(std::vector<wamp_message>&& messages)
+{
+    msgpack::sbuffer buffer;
+    msgpack::packer<msgpack::sbuffer> packer(buffer);
+
+    for (const auto& message : messages) {
+        // Reserve the length prefix and fill it in once the message is serialized.
+        const std::size_t header_offset = buffer.size();
+        uint32_t length = 0;
+        buffer.write(reinterpret_cast<const char*>(&length), sizeof(length));
+
+        packer.pack(message.fields());
+
+        length = htonl((uint32_t) (buffer.size() - header_offset - sizeof(length)));
+        std::memcpy(buffer.data() + header_offset, &length, sizeof(length));
+    }
+
+    boost::asio::write(m_socket, boost::asio::buffer(buffer.data(), buffer.size()));
+
+    if (m_debug_enabled) {
+        std::cerr << "TX " << messages.size() << " messages (" << buffer.size() << " octets) ..." << std::endl;
+        for (const auto& message : messages) {
+            std::cerr << "TX message: " << message << std::endl;
+        }
+    }
+}
+
 template <class Socket>
 void wamp_rawsocket_transport<Socket>::set_pause_handler(pause_handler&& handler)
 {
@@ -301,10 +331,10 @@ void wamp_rawsocket_transport<Socket>::receive_message()
     boost::asio::async_read(
         m_socket,
         boost::asio::buffer(&m_message_length, sizeof(m_message_length)),
-        bind(&wamp_rawsocket_transport<Socket>::receive_message_header,
+        m_strand.wrap(bind(&wamp_rawsocket_transport<Socket>::receive_message_header,
             this->shared_from_this(),
             boost::asio::placeholders::error,
-            boost::asio::placeholders::bytes_transferred));
+            boost::asio::placeholders::bytes_transferred)));
 }
 
 template <class Socket>
@@ -324,10 +354,10 @@ void wamp_rawsocket_transport<Socket>::receive_message_header(
         boost::asio::async_read(
             m_socket,
             boost::asio::buffer(m_message_unpacker.buffer(), m_message_length),
-            bind(&wamp_rawsocket_transport<Socket>::receive_message_body,
+            m_strand.wrap(bind(&wamp_rawsocket_transport<Socket>::receive_message_body,
                 this->shared_from_this(),
                 boost::asio::placeholders::error,
-                boost::asio::placeholders::bytes_transferred));
+                boost::asio::placeholders::bytes_transferred)));
         return;
     }
 }
@@ -31,9 +31,12 @@
 #ifndef AUTOBAHN_WAMP_REGISTER_REQUEST_HPP
 #define AUTOBAHN_WAMP_REGISTER_REQUEST_HPP
 
+#include "wamp_admission_control.hpp"
+#include "wamp_completion.hpp"
 #include "wamp_procedure.hpp"
 #include "wamp_registration.hpp"
-#include "boost_config.hpp"
+
+#include <exception>
 
 namespace autobahn {
 
@@ -41,18 +44,25 @@ namespace autobahn {
 class wamp_register_request
 {
 public:
+    using completion_type = wamp_completion<void(std::exception_ptr, wamp_registration)>;
+
     wamp_register_request();
-    wamp_register_request(const wamp_procedure& procedure);
+    wamp_register_request(const wamp_procedure& procedure, completion_type&& completion);
+    wamp_register_request(
+            const wamp_procedure& procedure,
+            const wamp_admission_control& admission,
+            completion_type&& completion);
     wamp_register_request(wamp_register_request&& other);
 
     const wamp_procedure& procedure() const;
-    boost::promise<wamp_registration>& response();
-    void set_procedure(wamp_procedure procedure) const;
+    const wamp_admission_control& admission() const;
     void set_response(const wamp_registration& registration);
+    void set_exception(std::exception_ptr exception);
 
 private:
     wamp_procedure m_procedure;
-    boost::promise<wamp_registration> m_response;
+    wamp_admission_control m_admission;
+    completion_type m_completion;
 };
 
 } // namespace autobahn
@@ -32,19 +32,33 @@ namespace autobahn {
 
 inline wamp_register_request::wamp_register_request()
     : m_procedure()
-    , m_response()
+    , m_admission()
+    , m_completion()
 {
 }
 
-inline wamp_register_request::wamp_register_request(const wamp_procedure& procedure)
+inline wamp_register_request::wamp_register_request(
+        const wamp_procedure& procedure, completion_type&& completion)
     : m_procedure(procedure)
-    , m_response()
+    , m_admission()
+    , m_completion(std::move(completion))
+{
+}
+
+inline wamp_register_request::wamp_register_request(
+        const wamp_procedure& procedure,
+        const wamp_admission_control& admission,
+        completion_type&& completion)
+    : m_procedure(procedure)
+    , m_admission(admission)
+    , m_completion(std::move(completion))
 {
 }
 
 inline wamp_register_request::wamp_register_request(wamp_register_request&& other)
     : m_procedure(std::move(other.m_procedure))
-    , m_response(std::move(other.m_response))
+    , m_admission(std::move(other.m_admission))
+    , m_completion(std::move(other.m_completion))
 {
 }
 
@@ -53,14 +67,19 @@ inline const wamp_procedure& wamp_register_request::procedure() const
     return m_procedure;
 }
 
-inline boost::promise<wamp_registration>& wamp_register_request::response()
+inline const wamp_admission_control& wamp_register_request::admission() const
 {
-    return m_response;
+    return m_admission;
 }
 
 inline void wamp_register_request::set_response(const wamp_registration& registration)
 {
-    m_response.set_value(registration);
+    m_completion.complete(nullptr, registration);
+}
+
+inline void wamp_register_request::set_exception(std::exception_ptr exception)
+{
+    m_completion.fail(std::move(exception));
 }
 
 } // namespace autobahn
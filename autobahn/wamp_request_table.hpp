@@ -0,0 +1,118 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Crossbar.io Technologies GmbH and contributors
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef AUTOBAHN_WAMP_REQUEST_TABLE_HPP
+#define AUTOBAHN_WAMP_REQUEST_TABLE_HPP
+
+#include <boost/optional.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+namespace autobahn {
+
+/*!
+ * Table of records keyed by WAMP id, used for outstanding requests by request id
+ * as well as for event handlers and procedures by subscription and registration id.
+ *
+ * Records are stored by value in a single open-addressing slot array with linear
+ * probing, so tracking a request neither allocates a node nor a shared_ptr once
+ * the table has grown to the number of requests in flight. Ids are spread over the
+ * slots by fibonacci hashing, which also copes with sequentially handed out request ids.
+ * Erasing shifts the following records back instead of leaving tombstones, which
+ * keeps look-ups short however many requests complete.
+ *
+ * The id 0 is reserved to mark empty slots, which is never used by WAMP.
+ * The table is not thread safe; the session only uses it on its io_service.
+ */
+template <typename T>
+class wamp_request_table
+{
+public:
+    wamp_request_table();
+    ~wamp_request_table();
+
+    wamp_request_table(const wamp_request_table&) = delete;
+    wamp_request_table& operator=(const wamp_request_table&) = delete;
+
+    /*!
+     * Adds a record for the given request id, which must not be in the table.
+     */
+    template <typename... Args>
+    T& emplace(uint64_t id, Args&&... args);
+
+    /*!
+     * Returns the record for the given request id, or nullptr. The pointer is
+     * invalidated by the next emplace() or erase().
+     */
+    T* find(uint64_t id);
+
+    /*!
+     * Removes the record for the given request id and returns it, which allows
+     * to complete a request without it being reachable from the table anymore.
+     */
+    boost::optional<T> take(uint64_t id);
+
+    bool erase(uint64_t id);
+    void clear();
+
+    std::size_t size() const;
+    bool empty() const;
+
+private:
+    struct slot
+    {
+        uint64_t id;
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+
+        T& value();
+    };
+
+    static const std::size_t MINIMUM_CAPACITY = 16;
+
+    std::size_t home(uint64_t id) const;
+    std::size_t position(uint64_t id) const;
+    void remove(std::size_t index);
+    void grow();
+
+    std::unique_ptr<slot[]> m_slots;
+    std::size_t m_capacity;
+    std::size_t m_size;
+    unsigned m_shift;
+};
+
+} // namespace autobahn
+
+#include "wamp_request_table.ipp"
+
+#endif // AUTOBAHN_WAMP_REQUEST_TABLE_HPP
@@ -0,0 +1,224 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Crossbar.io Technologies GmbH and contributors
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include <new>
+#include <utility>
+
+namespace autobahn {
+
+template <typename T>
+inline T& wamp_request_table<T>::slot::value()
+{
+    return *reinterpret_cast<T*>(&storage);
+}
+
+template <typename T>
+inline wamp_request_table<T>::wamp_request_table()
+    : m_slots()
+    , m_capacity(0)
+    , m_size(0)
+    , m_shift(64)
+{
+}
+
+template <typename T>
+inline wamp_request_table<T>::~wamp_request_table()
+{
+    clear();
+}
+
+template <typename T>
+template <typename... Args>
+inline T& wamp_request_table<T>::emplace(uint64_t id, Args&&... args)
+{
+    if ((m_size + 1) * 2 > m_capacity) {
+        grow();
+    }
+
+    const std::size_t mask = m_capacity - 1;
+    std::size_t index = home(id);
+    while (m_slots[index].id != 0) {
+        index = (index + 1) & mask;
+    }
+
+    slot& target = m_slots[index];
+    new (&target.storage) T(std::forward<Args>(args)...);
+    target.id = id;
+    ++m_size;
+
+    return target.value();
+}
+
+template <typename T>
+inline T* wamp_request_table<T>::find(uint64_t id)
+{
+    const std::size_t index = position(id);
+    return index != m_capacity ? &m_slots[index].value() : nullptr;
+}
+
+template <typename T>
+inline boost::optional<T> wamp_request_table<T>::take(uint64_t id)
+{
+    const std::size_t index = position(id);
+    if (index == m_capacity) {
+        return boost::none;
+    }
+
+    boost::optional<T> record(std::move(m_slots[index].value()));
+    remove(index);
+
+    return record;
+}
+
+template <typename T>
+inline bool wamp_request_table<T>::erase(uint64_t id)
+{
+    const std::size_t index = position(id);
+    if (index == m_capacity) {
+        return false;
+    }
+
+    remove(index);
+    return true;
+}
+
+template <typename T>
+inline void wamp_request_table<T>::clear()
+{
+    for (std::size_t index = 0; m_size > 0 && index < m_capacity; ++index) {
+        if (m_slots[index].id != 0) {
+            m_slots[index].value().~T();
+            m_slots[index].id = 0;
+            --m_size;
+        }
+    }
+}
+
+template <typename T>
+inline std::size_t wamp_request_table<T>::size() const
+{
+    return m_size;
+}
+
+template <typename T>
+inline bool wamp_request_table<T>::empty() const
+{
+    return m_size == 0;
+}
+
+template <typename T>
+inline std::size_t wamp_request_table<T>::home(uint64_t id) const
+{
+    return static_cast<std::size_t>((id * UINT64_C(0x9e3779b97f4a7c15)) >> m_shift);
+}
+
+template <typename T>
+inline std::size_t wamp_request_table<T>::position(uint64_t id) const
+{
+    if (m_size == 0 || id == 0) {
+        return m_capacity;
+    }
+
+    const std::size_t mask = m_capacity - 1;
+    for (std::size_t index = home(id); m_slots[index].id != 0; index = (index + 1) & mask) {
+        if (m_slots[index].id == id) {
+            return index;
+        }
+    }
+
+    return m_capacity;
+}
+
+template <typename T>
+inline void wamp_request_table<T>::remove(std::size_t index)
+{
+    const std::size_t mask = m_capacity - 1;
+
+    m_slots[index].value().~T();
+    --m_size;
+
+    // Shift back the records following in the probe sequence, unless that
+    // would move them in front of their home slot.
+    std::size_t next = (index + 1) & mask;
+    while (m_slots[next].id != 0) {
+        const std::size_t next_home = home(m_slots[next].id);
+        if (((next - next_home) & mask) >= ((next - index) & mask)) {
+            new (&m_slots[index].storage) T(std::move(m_slots[next].value()));
+            m_slots[index].id = m_slots[next].id;
+            m_slots[next].value().~T();
+            index = next;
+        }
+        next = (next + 1) & mask;
+    }
+
+    m_slots[index].id = 0;
+}
+
+template <typename T>
+inline void wamp_request_table<T>::grow()
+{
+    const std::size_t capacity = m_capacity ? m_capacity * 2 : MINIMUM_CAPACITY;
+    unsigned shift = 64;
+    for (std::size_t c = capacity; c > 1; c >>= 1) {
+        --shift;
+    }
+
+    std::unique_ptr<slot[]> slots(new slot[capacity]);
+    for (std::size_t index = 0; index < capacity; ++index) {
+        slots[index].id = 0;
+    }
+
+    std::unique_ptr<slot[]> previous_slots(std::move(m_slots));
+    const std::size_t previous_capacity = m_capacity;
+
+    m_slots = std::move(slots);
+    m_capacity = capacity;
+    m_shift = shift;
+
+    const std::size_t mask = m_capacity - 1;
+    for (std::size_t previous = 0; previous < previous_capacity; ++previous) {
+        slot& source = previous_slots[previous];
+        if (source.id == 0) {
+            continue;
+        }
+
+        std::size_t index = home(source.id);
+        while (m_slots[index].id != 0) {
+            index = (index + 1) & mask;
+        }
+
+        new (&m_slots[index].storage) T(std::move(source.value()));
+        m_slots[index].id = source.id;
+        source.value().~T();
+    }
+}
+
+} // namespace autobahn
@@ -0,0 +1,127 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Crossbar.io Technologies GmbH and contributors
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef AUTOBAHN_WAMP_SEND_COALESCING_HPP
+#define AUTOBAHN_WAMP_SEND_COALESCING_HPP
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace autobahn {
+
+class wamp_message;
+
+/*!
+ * Limits of the window in which the session coalesces outgoing messages
+ * into a single transport write, see wamp_session::set_send_coalescing().
+ */
+class wamp_send_coalescing
+{
+public:
+    /// Coalescing disabled: every message is written right away.
+    wamp_send_coalescing();
+
+    wamp_send_coalescing(
+            const std::chrono::microseconds& max_delay,
+            std::size_t max_bytes,
+            std::size_t max_messages);
+
+    /// How long a message may wait for others before it is written. Zero disables coalescing.
+    const std::chrono::microseconds& max_delay() const;
+    void set_max_delay(const std::chrono::microseconds& max_delay);
+
+    /// Flush once this many bytes are waiting, as estimated from the message contents. Zero for no limit.
+    std::size_t max_bytes() const;
+    void set_max_bytes(std::size_t max_bytes);
+
+    /// Flush once this many messages are waiting. Zero for no limit.
+    std::size_t max_messages() const;
+    void set_max_messages(std::size_t max_messages);
+
+    bool enabled() const;
+
+private:
+    std::chrono::microseconds m_max_delay;
+    std::size_t m_max_bytes;
+    std::size_t m_max_messages;
+};
+
+/*!
+ * Counters of the coalesced writes of a session, for tuning the
+ * coalescing window. See wamp_session::send_metrics().
+ */
+class wamp_send_metrics
+{
+public:
+    /// Batch sizes are counted in power of two buckets: 1, 2-3, 4-7, ..., the last one open ended.
+    static const std::size_t NUM_BATCH_SIZE_BUCKETS = 16;
+    using batch_size_histogram = std::array<uint64_t, NUM_BATCH_SIZE_BUCKETS>;
+
+    wamp_send_metrics();
+
+    /// Number of coalesced writes.
+    uint64_t flushes() const;
+
+    /// Number of messages written in coalesced writes.
+    uint64_t messages() const;
+
+    /// Estimated number of bytes written in coalesced writes.
+    uint64_t bytes() const;
+
+    /// The largest number of messages written at once.
+    std::size_t largest_batch() const;
+
+    /// Number of coalesced writes by batch size bucket.
+    const batch_size_histogram& batch_sizes() const;
+
+    //
+    // functions only called internally by wamp_session
+
+    void record_flush(std::size_t messages, std::size_t bytes);
+
+private:
+    uint64_t m_flushes;
+    uint64_t m_messages;
+    uint64_t m_bytes;
+    std::size_t m_largest_batch;
+    batch_size_histogram m_batch_sizes;
+};
+
+/// A cheap upper bound of the serialized size of a message.
+std::size_t estimated_message_size(const wamp_message& message);
+
+} // namespace autobahn
+
+#include "wamp_send_coalescing.ipp"
+
+#endif // AUTOBAHN_WAMP_SEND_COALESCING_HPP
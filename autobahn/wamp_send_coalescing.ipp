@@ -0,0 +1,182 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Crossbar.io Technologies GmbH and contributors
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include "wamp_message.hpp"
+
+#include <msgpack.hpp>
+
+namespace autobahn {
+
+inline wamp_send_coalescing::wamp_send_coalescing()
+    : m_max_delay(0)
+    , m_max_bytes(0)
+    , m_max_messages(0)
+{
+}
+
+inline wamp_send_coalescing::wamp_send_coalescing(
+        const std::chrono::microseconds& max_delay,
+        std::size_t max_bytes,
+        std::size_t max_messages)
+    : m_max_delay(max_delay)
+    , m_max_bytes(max_bytes)
+    , m_max_messages(max_messages)
+{
+}
+
+inline const std::chrono::microseconds& wamp_send_coalescing::max_delay() const
+{
+    return m_max_delay;
+}
+
+inline void wamp_send_coalescing::set_max_delay(const std::chrono::microseconds& max_delay)
+{
+    m_max_delay = max_delay;
+}
+
+inline std::size_t wamp_send_coalescing::max_bytes() const
+{
+    return m_max_bytes;
+}
+
+inline void wamp_send_coalescing::set_max_bytes(std::size_t max_bytes)
+{
+    m_max_bytes = max_bytes;
+}
+
+inline std::size_t wamp_send_coalescing::max_messages() const
+{
+    return m_max_messages;
+}
+
+inline void wamp_send_coalescing::set_max_messages(std::size_t max_messages)
+{
+    m_max_messages = max_messages;
+}
+
+inline bool wamp_send_coalescing::enabled() const
+{
+    return m_max_delay.count() > 0;
+}
+
+inline wamp_send_metrics::wamp_send_metrics()
+    : m_flushes(0)
+    , m_messages(0)
+    , m_bytes(0)
+    , m_largest_batch(0)
+    , m_batch_sizes()
+{
+}
+
+inline uint64_t wamp_send_metrics::flushes() const
+{
+    return m_flushes;
+}
+
+inline uint64_t wamp_send_metrics::messages() const
+{
+    return m_messages;
+}
+
+inline uint64_t wamp_send_metrics::bytes() const
+{
+    return m_bytes;
+}
+
+inline std::size_t wamp_send_metrics::largest_batch() const
+{
+    return m_largest_batch;
+}
+
+inline const wamp_send_metrics::batch_size_histogram& wamp_send_metrics::batch_sizes() const
+{
+    return m_batch_sizes;
+}
+
+inline void wamp_send_metrics::record_flush(std::size_t messages, std::size_t bytes)
+{
+    ++m_flushes;
+    m_messages += messages;
+    m_bytes += bytes;
+    if (messages > m_largest_batch) {
+        m_largest_batch = messages;
+    }
+
+    std::size_t bucket = 0;
+    while (messages > 1 && bucket + 1 < NUM_BATCH_SIZE_BUCKETS) {
+        messages >>= 1;
+        ++bucket;
+    }
+    ++m_batch_sizes[bucket];
+}
+
+inline std::size_t estimated_object_size(const msgpack::object& object)
+{
+    // Type tags and length prefixes take at most 5 bytes, scalars at most 9.
+    switch (object.type) {
+        case msgpack::type::STR:
+            return 5 + object.via.str.size;
+        case msgpack::type::BIN:
+            return 5 + object.via.bin.size;
+        case msgpack::type::EXT:
+            return 6 + object.via.ext.size;
+        case msgpack::type::ARRAY:
+            {
+                std::size_t size = 5;
+                for (uint32_t i = 0; i < object.via.array.size; ++i) {
+                    size += estimated_object_size(object.via.array.ptr[i]);
+                }
+                return size;
+            }
+        case msgpack::type::MAP:
+            {
+                std::size_t size = 5;
+                for (uint32_t i = 0; i < object.via.map.size; ++i) {
+                    size += estimated_object_size(object.via.map.ptr[i].key);
+                    size += estimated_object_size(object.via.map.ptr[i].val);
+                }
+                return size;
+            }
+        default:
+            return 9;
+    }
+}
+
+inline std::size_t estimated_message_size(const wamp_message& message)
+{
+    std::size_t size = 5;
+    for (const auto& field : message.fields()) {
+        size += estimated_object_size(field);
+    }
+    return size;
+}
+
+} // namespace autobahn
@@ -31,28 +31,52 @@
 #ifndef AUTOBAHN_SESSION_HPP
 #define AUTOBAHN_SESSION_HPP
 
+#include "wamp_admission_control.hpp"
+#include "wamp_batch_procedure.hpp"
+#include "wamp_batcher.hpp"
 #include "wamp_call_options.hpp"
 #include "wamp_call_result.hpp"
+#include "wamp_completion.hpp"
+#include "wamp_conflation.hpp"
+#include "wamp_coroutine_procedure.hpp"
+#include "wamp_event_channel.hpp"
 #include "wamp_event_handler.hpp"
+#include "wamp_invocation_pool.hpp"
+#include "wamp_invocation_scheduler.hpp"
 #include "wamp_message.hpp"
 #include "wamp_procedure.hpp"
+#include "wamp_progressive_call.hpp"
 #include "wamp_publish_options.hpp"
+#include "wamp_publish_request.hpp"
+#include "wamp_request_table.hpp"
+#include "wamp_send_coalescing.hpp"
+#include "wamp_submission_queue.hpp"
 #include "wamp_subscribe_options.hpp"
+#include "wamp_timer_wheel.hpp"
 #include "wamp_transport_handler.hpp"
+#include "wamp_typed_procedure.hpp"
 #include "boost_config.hpp"
 
 #include <boost/asio.hpp>
 
 #include <msgpack/object.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cstdint>
+#include <deque>
+#include <exception>
 #include <functional>
 #include <istream>
+#include <iterator>
 #include <ostream>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <stdexcept>
 #include <string>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -96,6 +120,9 @@ public:
     /*!
      * Create a new WAMP session.
      *
+     * All session state is serialized through an internal strand, so the
+     * io_service may be run on any number of threads.
+     *
      * \param io_service The io service to drive event dispatching.
      * \param debug_enabled Whether or not to run in debug mode.
      */
@@ -181,6 +208,151 @@ public:
             const Map& kw_arguments,
             const wamp_publish_options& options = wamp_publish_options());
 
+    /*!
+     * \ingroup PUB
+     * Publish an event with empty payload to a topic, completing through an
+     * Asio completion token.
+     *
+     * The operation completes with the signature void(std::exception_ptr) once
+     * the event has been sent, or once the broker acknowledged it if
+     * wamp_publish_options::set_acknowledge() was set. Any completion token can be used, e.g. a callback,
+     * boost::asio::use_future, or boost::asio::detached for fire-and-forget. A
+     * callback is invoked on the session's io_service unless it has an associated
+     * executor of its own.
+     *
+     * \param topic The URI of the topic to publish to.
+     * \param options The options to pass in the publish request to the router.
+     * \param token The completion token.
+     */
+    template <typename CompletionToken>
+    BOOST_ASIO_INITFN_RESULT_TYPE(CompletionToken, void(std::exception_ptr))
+    async_publish(
+            const std::string& topic,
+            const wamp_publish_options& options,
+            CompletionToken&& token);
+
+    /*!
+     * \ingroup PUB
+     * Publish an event with positional payload to a topic, completing through an
+     * Asio completion token as described above.
+     */
+    template <typename List, typename CompletionToken>
+    BOOST_ASIO_INITFN_RESULT_TYPE(CompletionToken, void(std::exception_ptr))
+    async_publish(
+            const std::string& topic,
+            const List& arguments,
+            const wamp_publish_options& options,
+            CompletionToken&& token);
+
+    /*!
+     * \ingroup PUB
+     * Publish an event with both positional and keyword payload to a topic,
+     * completing through an Asio completion token as described above.
+     */
+    template <typename List, typename Map, typename CompletionToken>
+    BOOST_ASIO_INITFN_RESULT_TYPE(CompletionToken, void(std::exception_ptr))
+    async_publish(
+            const std::string& topic,
+            const List& arguments,
+            const Map& kw_arguments,
+            const wamp_publish_options& options,
+            CompletionToken&& token);
+
+    /*!
+     * \ingroup PUB
+     * Publish an event with empty payload to a topic and have the broker acknowledge it,
+     * whether or not the options ask for it.
+     *
+     * The operation completes with the signature void(std::exception_ptr, wamp_publication)
+     * once the broker has accepted the publication, or fails with the broker's error.
+     *
+     * \param topic The URI of the topic to publish to.
+     * \param options The options to pass in the publish request to the router.
+     * \param token The completion token.
+     */
+    template <typename CompletionToken>
+    BOOST_ASIO_INITFN_RESULT_TYPE(CompletionToken, void(std::exception_ptr, wamp_publication))
+    async_publish_acknowledged(
+            const std::string& topic,
+            const wamp_publish_options& options,
+            CompletionToken&& token);
+
+    /*!
+     * \ingroup PUB
+     * Publish an event with positional payload to a topic and have the broker
+     * acknowledge it, as described above.
+     */
+    template <typename List, typename CompletionToken>
+    BOOST_ASIO_INITFN_RESULT_TYPE(CompletionToken, void(std::exception_ptr, wamp_publication))
+    async_publish_acknowledged(
+            const std::string& topic,
+            const List& arguments,
+            const wamp_publish_options& options,
+            CompletionToken&& token);
+
+    /*!
+     * \ingroup PUB
+     * Publish an event with both positional and keyword payload to a topic and
+     * have the broker acknowledge it, as described above.
+     */
+    template <typename List, typename Map, typename CompletionToken>
+    BOOST_ASIO_INITFN_RESULT_TYPE(CompletionToken, void(std::exception_ptr, wamp_publication))
+    async_publish_acknowledged(
+            const std::string& topic,
+            const List& arguments,
+            const Map& kw_arguments,
+            const wamp_publish_options& options,
+            CompletionToken&& token);
+
+    /*!
+     * \ingroup PUB
+     * Publish a batch of events to a topic, one per element of @p arguments, which
+     * is a range of positional payloads, e.g. a `std::vector<std::tuple<int>>`.
+     *
+     * All events are serialized up front and handed to the io_service at once, and
+     * transports that support it send them with a single write. This is much cheaper
+     * than publishing the events one by one, especially for small payloads.
+     *
+     * The events are published unacknowledged, regardless of the options.
+     *
+     * \param topic The URI of the topic to publish to.
+     * \param arguments The positional payloads of the events.
+     * \param options The options to pass in each publish request to the router.
+     * \return A future that resolves once all events have been sent.
+     */
+    template <typename Range>
+    boost::future<void> publish_batch(
+            const std::string& topic,
+            const Range& arguments,
+            const wamp_publish_options& options = wamp_publish_options());
+
+    /*!
+     * \ingroup PUB
+     * Publish a batch of events to a topic as described above, completing through
+     * an Asio completion token with the signature void(std::exception_ptr).
+     */
+    template <typename Range, typename CompletionToken>
+    BOOST_ASIO_INITFN_RESULT_TYPE(CompletionToken, void(std::exception_ptr))
+    async_publish_batch(
+            const std::string& topic,
+            const Range& arguments,
+            const wamp_publish_options& options,
+            CompletionToken&& token);
+
+    /*!
+     * \ingroup PUB
+     * Limits the number of acknowledged publications awaiting their acknowledgement.
+     *
+     * Further acknowledged publications are held back in order until the broker has
+     * acknowledged earlier ones, and their futures or completion handlers complete
+     * only then. Publishers waiting for their completions are thereby paced by the
+     * broker. Zero, the default, means no limit. Unacknowledged publications are
+     * not affected.
+     *
+     * Takes effect in order with the publications made before and after it.
+     */
+    void set_publish_window(std::size_t window);
+
     /*!
      * Subscribe a handler to a topic to receive events.
      *
@@ -194,6 +366,90 @@ public:
             const wamp_event_handler& handler,
             const wamp_subscribe_options& options = wamp_subscribe_options());
 
+    /*!
+     * Subscribe a handler to a topic to receive events on an executor.
+     *
+     * Instead of running inline on the session, the handler is invoked on
+     * @p executor, e.g. a thread pool or a strand. Events of this subscription
+     * are delivered in order, while handlers of other subscriptions may run
+     * in parallel.
+     *
+     * \param topic The URI of the topic to subscribe to.
+     * \param handler The handler that will receive events under the subscription.
+     * \param executor The executor to run the handler on.
+     * \param options The options to pass in the subscribe request to the router.
+     * \return A future that resolves to the autobahn::subscription.
+     */
+    template <typename Executor>
+    boost::future<wamp_subscription> subscribe(
+            const std::string& topic,
+            const wamp_event_handler& handler,
+            const Executor& executor,
+            const wamp_subscribe_options& options = wamp_subscribe_options(),
+            typename std::enable_if<boost::asio::is_executor<Executor>::value>::type* = nullptr);
+
+    /*!
+     * Subscribe a handler to a topic to receive conflated events on an executor.
+     *
+     * Like the executor overload, but while the handler is busy only the
+     * newest event per key of @p conflation waits for it; older undelivered
+     * events with the same key are dropped before their arguments are
+     * converted. For slow consumers of fast changing topics, such as quotes
+     * keyed by symbol.
+     *
+     * \param topic The URI of the topic to subscribe to.
+     * \param handler The handler that will receive events under the subscription.
+     * \param executor The executor to run the handler on.
+     * \param conflation The key events are conflated by; also holds the counters.
+     * \param options The options to pass in the subscribe request to the router.
+     * \return A future that resolves to the autobahn::subscription.
+     */
+    template <typename Executor>
+    boost::future<wamp_subscription> subscribe(
+            const std::string& topic,
+            const wamp_event_handler& handler,
+            const Executor& executor,
+            const wamp_conflation& conflation,
+            const wamp_subscribe_options& options = wamp_subscribe_options(),
+            typename std::enable_if<boost::asio::is_executor<Executor>::value>::type* = nullptr);
+
+    /*!
+     * Subscribe a handler to a topic to receive events in batches.
+     *
+     * Events of the subscription are collected on the session until the batch
+     * is full or its first event has waited the maximum time, then handed to
+     * @p handler at once, in arrival order. A zero wait delivers the events
+     * that arrived in one transport read together.
+     *
+     * \param topic The URI of the topic to subscribe to.
+     * \param handler The handler that will receive batches of events under the subscription.
+     * \param batch_options How events are collected into batches.
+     * \param options The options to pass in the subscribe request to the router.
+     * \return A future that resolves to the autobahn::subscription.
+     */
+    boost::future<wamp_subscription> subscribe_batch(
+            const std::string& topic,
+            const wamp_batch_event_handler& handler,
+            const wamp_batch_options& batch_options = wamp_batch_options(),
+            const wamp_subscribe_options& options = wamp_subscribe_options());
+
+    /*!
+     * Subscribe a handler to a topic, completing through an Asio completion token
+     * with the signature void(std::exception_ptr, wamp_subscription).
+     *
+     * \param topic The URI of the topic to subscribe to.
+     * \param handler The handler that will receive events under the subscription.
+     * \param options The options to pass in the subscribe request to the router.
+     * \param token The completion token.
+     */
+    template <typename CompletionToken>
+    BOOST_ASIO_INITFN_RESULT_TYPE(CompletionToken, void(std::exception_ptr, wamp_subscription))
+    async_subscribe(
+            const std::string& topic,
+            const wamp_event_handler& handler,
+            const wamp_subscribe_options& options,
+            CompletionToken&& token);
+
     /*!
      * Unubscribe a handler to previously subscribed topic.
      *
@@ -242,6 +498,109 @@ public:
             const List& arguments, const Map& kw_arguments,
             const wamp_call_options& options = wamp_call_options());
 
+    /*!
+     * Calls a remote procedure with no arguments, completing through an Asio
+     * completion token with the signature void(std::exception_ptr, wamp_call_result).
+     *
+     * Besides boost::future, this allows to receive the result in a plain callback,
+     * which is invoked on the session's io_service unless it has an associated
+     * executor of its own, or through tokens such as boost::asio::use_awaitable.
+     * Small callbacks are kept in the pending call record and do not allocate.
+     *
+     * \param procedure The URI of the remote procedure to call.
+     * \param options The options to pass in the call to the router.
+     * \param token The completion token.
+     */
+    template <typename CompletionToken>
+    BOOST_ASIO_INITFN_RESULT_TYPE(CompletionToken, void(std::exception_ptr, wamp_call_result))
+    async_call(
+            const std::string& procedure,
+            const wamp_call_options& options,
+            CompletionToken&& token);
+
+    /*!
+     * Calls a remote procedure with positional arguments, completing through an
+     * Asio completion token as described above.
+     */
+    template <typename List, typename CompletionToken>
+    BOOST_ASIO_INITFN_RESULT_TYPE(CompletionToken, void(std::exception_ptr, wamp_call_result))
+    async_call(
+            const std::string& procedure,
+            const List& arguments,
+            const wamp_call_options& options,
+            CompletionToken&& token);
+
+    /*!
+     * Calls a remote procedure with positional and keyword arguments, completing
+     * through an Asio completion token as described above.
+     */
+    template <typename List, typename Map, typename CompletionToken>
+    BOOST_ASIO_INITFN_RESULT_TYPE(CompletionToken, void(std::exception_ptr, wamp_call_result))
+    async_call(
+            const std::string& procedure,
+            const List& arguments,
+            const Map& kw_arguments,
+            const wamp_call_options& options,
+            CompletionToken&& token);
+
+    /*!
+     * Opens a call whose arguments are sent in chunks with wamp_progressive_call::progress()
+     * and wamp_progressive_call::finish(), as progressive call invocations.
+     *
+     * Nothing is sent before the first chunk. Call options such as the timeout and the
+     * progress handler apply to the whole call. The dealer and the callee must support
+     * progressive call invocations.
+     *
+     * \param procedure The URI of the remote procedure to call.
+     * \param options The options to pass in the call to the router.
+     * \return The open call, through which the chunks are sent.
+     */
+    wamp_progressive_call open_call(
+            const std::string& procedure,
+            const wamp_call_options& options = wamp_call_options());
+
+    /*!
+     * Calls a remote procedure through its C++ signature, e.g.
+     * typed_call<int(int, int)>("com.example.add2", 2, 3).
+     *
+     * The arguments are converted to the parameter types of the signature when the
+     * call is made, and the first positional result is converted to the result type.
+     * A signature returning void ignores the results.
+     *
+     * \param procedure The URI of the remote procedure to call.
+     * \param params The arguments for the call, one per parameter of the signature.
+     * \return A future that resolves to the converted result of the remote procedure call.
+     */
+    template <typename Signature, typename... Params>
+    typed_call_future<Signature, sizeof...(Params)> typed_call(
+            const std::string& procedure,
+            Params&&... params);
+
+    /*!
+     * Calls a remote procedure through its C++ signature, passing call options.
+     *
+     * \param procedure The URI of the remote procedure to call.
+     * \param options The options to pass in the call to the router.
+     * \param params The arguments for the call, one per parameter of the signature.
+     * \return A future that resolves to the converted result of the remote procedure call.
+     */
+    template <typename Signature, typename... Params>
+    typed_call_future<Signature, sizeof...(Params)> typed_call(
+            const std::string& procedure,
+            const wamp_call_options& options,
+            Params&&... params);
+
+    /*!
+     * Set the pool that procedures provided from now on run their
+     * invocations on, instead of inline on the session: a
+     * wamp_invocation_pool, or a class of a wamp_invocation_scheduler.
+     * Null, the default, runs them inline. A CPU heavy procedure run inline holds up receiving
+     * messages and every other registration.
+     *
+     * Procedures provided before keep running on the pool they were provided with.
+     */
+    void set_invocation_pool(const std::shared_ptr<wamp_invocation_executor>& pool);
+
     /*!
      * Register a procedure that can be called remotely.
      *
@@ -255,6 +614,144 @@ public:
             const wamp_procedure& procedure,
             const provide_options& options = provide_options());
 
+    /*!
+     * Register a procedure that runs its invocations on the given pool.
+     *
+     * A null @p pool pins the procedure to the session, which runs it inline
+     * as soon as the invocation arrives. Use this for trivially cheap
+     * procedures when a default pool is set, see set_invocation_pool().
+     *
+     * \param uri The URI associated with the procedure.
+     * \param procedure The procedure to be exposed as a remotely callable procedure.
+     * \param pool The pool or scheduler class to run invocations on, or null to run them inline.
+     * \param options Options for registering the procedure.
+     * \return A future that resolves to a autobahn::registration
+     */
+    boost::future<wamp_registration> provide(
+            const std::string& uri,
+            const wamp_procedure& procedure,
+            const std::shared_ptr<wamp_invocation_executor>& pool,
+            const provide_options& options = provide_options());
+
+    /*!
+     * Register a procedure whose invocations are subject to admission control.
+     *
+     * Invocations beyond the limits of @p admission are answered with its
+     * error URI right away instead of being run; see wamp_admission_control.
+     * Admitted invocations run like those of any procedure, on the pool set
+     * with set_invocation_pool() if there is one. The counters of the
+     * registration are available from @p admission or any copy of it.
+     *
+     * \param uri The URI associated with the procedure.
+     * \param procedure The procedure to be exposed as a remotely callable procedure.
+     * \param admission The limits to admit invocations under.
+     * \param options Options for registering the procedure.
+     * \return A future that resolves to a autobahn::registration
+     */
+    boost::future<wamp_registration> provide(
+            const std::string& uri,
+            const wamp_procedure& procedure,
+            const wamp_admission_control& admission,
+            const provide_options& options = provide_options());
+
+    /*!
+     * Register a procedure that can be called remotely, completing through an Asio
+     * completion token with the signature void(std::exception_ptr, wamp_registration).
+     *
+     * \param uri The URI associated with the procedure.
+     * \param procedure The procedure to be exposed as a remotely callable procedure.
+     * \param options Options for registering the procedure.
+     * \param token The completion token.
+     */
+    template <typename CompletionToken>
+    BOOST_ASIO_INITFN_RESULT_TYPE(CompletionToken, void(std::exception_ptr, wamp_registration))
+    async_provide(
+            const std::string& uri,
+            const wamp_procedure& procedure,
+            const provide_options& options,
+            CompletionToken&& token);
+
+    /*!
+     * Register a procedure under admission control, completing through an Asio
+     * completion token with the signature void(std::exception_ptr, wamp_registration).
+     *
+     * \param uri The URI associated with the procedure.
+     * \param procedure The procedure to be exposed as a remotely callable procedure.
+     * \param admission The limits to admit invocations under.
+     * \param options Options for registering the procedure.
+     * \param token The completion token.
+     */
+    template <typename CompletionToken>
+    BOOST_ASIO_INITFN_RESULT_TYPE(CompletionToken, void(std::exception_ptr, wamp_registration))
+    async_provide(
+            const std::string& uri,
+            const wamp_procedure& procedure,
+            const wamp_admission_control& admission,
+            const provide_options& options,
+            CompletionToken&& token);
+
+    /*!
+     * Register a procedure that handles its invocations in batches.
+     *
+     * Invocations are collected on the session until the batch is full or its
+     * first invocation has waited the maximum time, then handed to @p procedure
+     * at once, on the pool set with set_invocation_pool() if there is one.
+     * Each invocation is replied to individually; those not replied to when
+     * @p procedure throws get wamp.error.runtime_error.
+     *
+     * \param uri The URI associated with the procedure.
+     * \param procedure The procedure to be exposed as a remotely callable procedure.
+     * \param batch_options How invocations are collected into batches.
+     * \param options Options for registering the procedure.
+     * \return A future that resolves to a autobahn::registration
+     */
+    boost::future<wamp_registration> provide_batch(
+            const std::string& uri,
+            const wamp_batch_procedure& procedure,
+            const wamp_batch_options& batch_options = wamp_batch_options(),
+            const provide_options& options = provide_options());
+
+    /*!
+     * Register a function with the given signature that can be called remotely,
+     * e.g. provide<int(int, int)>("com.example.add2", [](int a, int b) { return a + b; }).
+     *
+     * The positional arguments of each invocation are converted to the parameter types
+     * and the return value is sent as the only positional result. Invocations with a
+     * different number or type of arguments fail with wamp.error.invalid_argument.
+     *
+     * \param uri The URI associated with the procedure.
+     * \param function The function to be exposed as a remotely callable procedure.
+     * \param options Options for registering the procedure.
+     * \return A future that resolves to a autobahn::registration
+     */
+    template <typename Signature, typename Function>
+    boost::future<wamp_registration> provide(
+            const std::string& uri,
+            Function&& function,
+            const provide_options& options = provide_options());
+
+#if defined(BOOST_ASIO_HAS_CO_AWAIT)
+    /*!
+     * Register a coroutine procedure that can be called remotely, i.e. a function
+     * taking the wamp_invocation and returning a boost::asio::awaitable.
+     *
+     * The coroutine runs on the session's io_service and can co_await other session
+     * operations, e.g. async_call(..., boost::asio::use_awaitable). The value it
+     * co_returns is sent as the positional arguments of the result, and exceptions
+     * escaping it are sent as wamp.error.runtime_error.
+     *
+     * \param uri The URI associated with the procedure.
+     * \param function The coroutine to be exposed as a remotely callable procedure.
+     * \param options Options for registering the procedure.
+     * \return A future that resolves to a autobahn::registration
+     */
+    template <typename Function>
+    coroutine_provide_future<Function> provide(
+            const std::string& uri,
+            Function&& function,
+            const provide_options& options = provide_options());
+#endif
+
     /*!
     * Unregister a handler to previosly registered service.
     *
@@ -307,6 +804,50 @@ public:
     */
     const std::unordered_map<std::string, msgpack::object>& welcome_details();
 
+    /*!
+     * Coalesces outgoing messages of the joined session into single transport writes.
+     *
+     * A message waits at most the maximum delay for others to join it, and is flushed
+     * earlier once the maximum number of bytes or messages is waiting. This applies to
+     * all messages sent once the session is joined, e.g. publications from many producers
+     * and YIELDs of many concurrent invocations. Operations complete once their message
+     * is queued, not once it is written. A zero delay, the default, disables coalescing.
+     */
+    void set_send_coalescing(const wamp_send_coalescing& coalescing);
+
+    /*!
+     * Holds back outgoing messages until the matching uncork(), e.g. around a burst of
+     * publications, so that they are written at once. The byte and message limits of
+     * set_send_coalescing() still apply, if set. Calls can be nested.
+     */
+    void cork();
+
+    /*!
+     * Ends a cork(), flushing the held back messages once the outermost one ends.
+     */
+    void uncork();
+
+    /*!
+     * Corks the session for the lifetime of the scope object.
+     */
+    class cork_scope
+    {
+    public:
+        explicit cork_scope(wamp_session& session);
+        ~cork_scope();
+
+        cork_scope(const cork_scope&) = delete;
+        cork_scope& operator=(const cork_scope&) = delete;
+
+    private:
+        wamp_session& m_session;
+    };
+
+    /*!
+     * The counters of the coalesced writes so far, e.g. the batch sizes per flush.
+     */
+    wamp_send_metrics send_metrics() const;
+
 private:
     // Implements the wamp transport handler interface.
     virtual void on_attach(const std::shared_ptr<wamp_transport>& transport) override;
@@ -319,27 +860,238 @@ private:
     void process_abort(wamp_message&& message);
     void process_challenge(wamp_message&& message);
     void process_call_result(wamp_message&& message);
+    void process_published(wamp_message&& message);
     void process_subscribed(wamp_message&& message);
     void process_unsubscribed(wamp_message&& message);
     void process_event(wamp_message&& message);
     void process_registered(wamp_message&& message);
     void process_unregistered(wamp_message&& message);
     void process_invocation(wamp_message&& message);
+    void process_interrupt(wamp_message&& message);
     void process_goodbye(wamp_message&& message);
 
     // Transmitting/receiving messages
     void send_message(wamp_message&& message, bool session_established = true);
+    void send_messages(std::vector<wamp_message>&& messages);
+    void queue_message(wamp_message&& message);
+    void flush_send_queue();
+    void try_flush_send_queue();
+    void on_flush_timer(const boost::system::error_code& error);
     void receive_message();
+    void process_message(wamp_message&& message);
+
+    // Handing operations over to the session strand. Every operation of the
+    // application goes through submit(), so they take effect in the order made.
+    template <typename Operation>
+    void submit(Operation&& operation);
+    void submit_overflow(std::unique_ptr<wamp_submission>&& submission);
+    void schedule_drain();
+    void drain_submissions();
 
     void got_handshake_reply(const boost::system::error_code& error);
     void got_message_header(const boost::system::error_code& error);
     void got_message_body(const boost::system::error_code& error);
     void got_message(wamp_message&& message);
 
+    // Asynchronous operations, handing messages and pending requests to the io_service.
+    class publish_initiation
+    {
+    public:
+        explicit publish_initiation(const std::shared_ptr<wamp_session>& session);
+
+        template <typename Handler, typename Message>
+        void operator()(Handler&& handler, uint64_t request_id, Message&& message, bool acknowledge) const;
+
+        template <typename Handler>
+        void operator()(Handler&& handler, std::vector<wamp_message>&& messages) const;
+
+    private:
+        std::weak_ptr<wamp_session> m_session;
+    };
+
+    class publish_operation
+    {
+    public:
+        using completion_type = wamp_completion<void(std::exception_ptr)>;
+
+        publish_operation(
+                const std::weak_ptr<wamp_session>& session,
+                wamp_message&& message,
+                completion_type&& completion);
+
+        void operator()();
+
+    private:
+        std::weak_ptr<wamp_session> m_session;
+        wamp_message m_message;
+        completion_type m_completion;
+    };
+
+    class publish_batch_operation
+    {
+    public:
+        using completion_type = wamp_completion<void(std::exception_ptr)>;
+
+        publish_batch_operation(
+                const std::weak_ptr<wamp_session>& session,
+                std::vector<wamp_message>&& messages,
+                completion_type&& completion);
+
+        void operator()();
+
+    private:
+        std::weak_ptr<wamp_session> m_session;
+        std::vector<wamp_message> m_messages;
+        completion_type m_completion;
+    };
+
+    template <typename Record>
+    class request_initiation
+    {
+    public:
+        request_initiation(
+                const std::shared_ptr<wamp_session>& session,
+                wamp_request_table<Record> wamp_session::* requests);
+
+        template <typename Handler, typename Message, typename... RecordArgs>
+        void operator()(
+                Handler&& handler, uint64_t request_id,
+                Message&& message, RecordArgs&&... record_args) const;
+
+    private:
+        std::weak_ptr<wamp_session> m_session;
+        wamp_request_table<Record> wamp_session::* m_requests;
+    };
+
+    template <typename Record>
+    class request_operation
+    {
+    public:
+        request_operation(
+                const std::weak_ptr<wamp_session>& session,
+                wamp_request_table<Record> wamp_session::* requests,
+                uint64_t request_id,
+                wamp_message&& message,
+                Record&& record);
+
+        void operator()();
+
+    private:
+        std::weak_ptr<wamp_session> m_session;
+        wamp_request_table<Record> wamp_session::* m_requests;
+        uint64_t m_request_id;
+        wamp_message m_message;
+        Record m_record;
+    };
+
+    // Holding back requests, only acknowledged publications for now
+    template <typename Record>
+    bool admit_request(uint64_t request_id, wamp_message& message, Record& record);
+    bool admit_request(uint64_t request_id, wamp_message& message, wamp_publish_request& request);
+    void release_publication_slots();
+
+    static std::unordered_map<std::string, bool> publish_options_map(
+            const wamp_publish_options& options, bool acknowledge);
+
+    // Enforcing call timeouts
+    template <typename Record>
+    void track_request(uint64_t request_id, Record& record);
+    void track_request(uint64_t request_id, wamp_call& call);
+    void arm_call_timer();
+    void on_call_timer(const boost::system::error_code& error);
+    boost::optional<wamp_call> take_call(uint64_t request_id);
+    bool forget_canceled_call(uint64_t request_id);
+    void abandon_call(uint64_t request_id, wamp_cancel_mode mode, std::exception_ptr exception);
+
+    // Sending the chunks of progressive calls after the first one
+    void send_call_chunk(uint64_t request_id, wamp_message&& message);
+
+    // Running procedures and replying to invocations
+    static void invoke_procedure(const wamp_procedure& procedure, const wamp_invocation& invocation);
+    static void invoke_batch_procedure(
+            const wamp_batch_procedure& procedure, const std::vector<wamp_invocation>& invocations);
+    static wamp_procedure pooled_procedure(
+            const std::shared_ptr<wamp_invocation_executor>& pool, const wamp_procedure& procedure);
+    std::shared_ptr<wamp_invocation_executor> invocation_pool() const;
+    void arm_admission_timer(const wamp_admission_control& admission);
+    void on_admission_timer(const boost::system::error_code& error);
+    void start_admitted_invocation(
+            uint64_t registration_id,
+            uint64_t request_id,
+            const wamp_invocation& invocation,
+            const std::shared_ptr<wamp_admission_slot>& slot);
+    wamp_invocation_impl::send_result_fn invocation_reply_fn(
+            uint64_t request_id, const std::shared_ptr<wamp_admission_slot>& slot);
+    void submit_invocation_reply(uint64_t request_id, const std::shared_ptr<wamp_message>& message);
+    void send_invocation_reply(uint64_t request_id, wamp_message&& message);
+
+    static bool has_role_feature(const msgpack::object& details, const char* role, const char* feature);
+
+    // Modifying the subscription and procedure tables
+    template <typename Update>
+    void update_dispatch_tables(Update&& update);
+
+    class dispatch_guard
+    {
+    public:
+        explicit dispatch_guard(wamp_session& session);
+        ~dispatch_guard();
+
+    private:
+        wamp_session& m_session;
+    };
+
     bool m_debug_enabled;
 
     boost::asio::io_service& m_io_service;
 
+    // Serializes all access to the session state below.
+    boost::asio::io_service::strand m_strand;
+
+    // Timer driving the call deadlines, armed while there are deadlines pending.
+    boost::asio::steady_timer m_call_timer;
+    bool m_call_timer_armed;
+
+    // Timer rejecting queued invocations once they waited longer than their
+    // admission control allows, armed for the oldest one of all controls.
+    boost::asio::steady_timer m_admission_timer;
+    bool m_admission_timer_armed;
+    std::chrono::steady_clock::time_point m_admission_deadline;
+    std::vector<wamp_admission_control> m_queued_admissions;
+
+    // Coalescing of outgoing messages, see set_send_coalescing().
+    wamp_send_coalescing m_send_coalescing;
+    unsigned m_cork_depth;
+    std::vector<wamp_message> m_send_queue;
+    std::size_t m_send_queue_bytes;
+    std::vector<wamp_message> m_send_batch;
+    boost::asio::steady_timer m_flush_timer;
+    bool m_flush_timer_armed;
+
+    mutable std::mutex m_send_metrics_mutex;
+    wamp_send_metrics m_send_metrics;
+
+    // Operations submitted from other threads, drained by a single handler
+    // on the session strand, see submit().
+    wamp_submission_queue<std::unique_ptr<wamp_submission>> m_submissions;
+
+    // Invocation replies from other threads, drained along with m_submissions.
+    struct invocation_reply
+    {
+        uint64_t request_id;
+        std::shared_ptr<wamp_message> message;
+    };
+    wamp_submission_queue<invocation_reply> m_invocation_replies;
+    std::atomic<bool> m_drain_scheduled;
+
+    // Submissions that found their ring full. Producers never wait for the
+    // strand, which may have to run on their own thread. While any are held
+    // here, later submissions line up behind them instead of overtaking them
+    // through the rings.
+    std::mutex m_overflow_mutex;
+    std::vector<std::unique_ptr<wamp_submission>> m_overflow;
+    std::atomic<bool> m_overflowing;
+
     // The transport this session runs on.
     std::shared_ptr<wamp_transport> m_transport;
 
@@ -370,31 +1122,83 @@ private:
     // Caller
 
     // Track pending calls by request id.
-    std::map<uint64_t /*request id*/, std::shared_ptr<wamp_call>> m_calls;
+    wamp_request_table<wamp_call> m_calls;
+
+    // Deadlines of pending calls with a timeout.
+    wamp_timer_wheel m_call_deadlines;
+
+    // Calls canceled or timed out locally, whose RESULT or ERROR is still to be
+    // ignored, with the end of their lingering in m_call_deadlines.
+    wamp_request_table<wamp_timer_wheel::handle> m_canceled_calls;
+
+    // Whether the dealer announced the call_canceling feature.
+    bool m_call_canceling;
+
+    //////////////////////////////////////////////////////////////////////////////////////
+    // Publisher
+
+    // Acknowledged publications awaiting PUBLISHED by request id.
+    wamp_request_table<wamp_publish_request> m_publish_requests;
+
+    // Maximum number of publications in m_publish_requests, zero for no limit.
+    std::size_t m_publish_window;
+
+    // Acknowledged publications held back by the publish window, in order.
+    struct queued_publication
+    {
+        uint64_t request_id;
+        wamp_message message;
+        wamp_publish_request request;
+    };
+    std::deque<queued_publication> m_queued_publications;
 
     //////////////////////////////////////////////////////////////////////////////////////
     // Subscriber
 
     // Pending subscribe requests by request id.
-    std::map<uint64_t /*request id*/, std::shared_ptr<wamp_subscribe_request>> m_subscribe_requests;
+    wamp_request_table<wamp_subscribe_request> m_subscribe_requests;
 
     // Pending unsubscribe requests by request id.
-    std::map<uint64_t /*request id*/, std::shared_ptr<wamp_unsubscribe_request>> m_unsubscribe_requests;
+    wamp_request_table<wamp_unsubscribe_request> m_unsubscribe_requests;
 
     // Event handlers by subscription id.
-    std::multimap<uint64_t /*subscription id*/, wamp_event_handler> m_subscription_handlers;
+    wamp_request_table<wamp_event_handlers> m_subscription_handlers;
 
     //////////////////////////////////////////////////////////////////////////////////////
     // Callee
 
     // Map of outstanding WAMP register requests (request ID -> register request).
-    std::map<uint64_t, std::shared_ptr<wamp_register_request>> m_register_requests;
+    wamp_request_table<wamp_register_request> m_register_requests;
 
     // Map of outstanding WAMP unregister requests (request ID -> unregister request).
-    std::map<uint64_t, std::shared_ptr<wamp_unregister_request>> m_unregister_requests;
+    wamp_request_table<wamp_unregister_request> m_unregister_requests;
 
     // Map of registered procedures (registration ID -> procedure)
-    std::map<uint64_t, wamp_procedure> m_procedures;
+    wamp_request_table<wamp_procedure> m_procedures;
+
+    // Admission control of registered procedures (registration ID -> control)
+    wamp_request_table<wamp_admission_control> m_admission_controls;
+
+    // Pool running the invocations of procedures provided without one. Set
+    // and read on application threads, so guarded by its own mutex.
+    mutable std::mutex m_invocation_pool_mutex;
+    std::shared_ptr<wamp_invocation_executor> m_invocation_pool;
+
+    // Invocations not replied to yet by request id, for routing INTERRUPT messages.
+    wamp_request_table<std::weak_ptr<wamp_invocation_impl>> m_invocations;
+
+    // Invocations still receiving progressive call arguments by request id.
+    wamp_request_table<std::weak_ptr<wamp_invocation_impl>> m_invocation_streams;
+
+    //////////////////////////////////////////////////////////////////////////////////////
+    // Dispatching
+
+    // Number of event handlers or procedures currently being run. The tables above
+    // are not modified while handlers run, as they are invoked in place.
+    unsigned m_dispatch_depth;
+
+    // Changes to the handler and procedure tables made while dispatching.
+    std::vector<std::function<void()>> m_deferred_table_updates;
 
     // Welcome details
     std::unordered_map<std::string, msgpack::object> m_welcome_details;
@@ -61,16 +61,46 @@
 
 namespace autobahn {
 
+// How long RESULT and ERROR messages of a call canceled or timed out locally
+// are still expected and ignored. Bounds the record of abandoned calls when the
+// dealer or the callee never answers.
+static const std::chrono::seconds WAMP_CANCELED_CALL_LINGER(60);
+
 inline wamp_session::wamp_session(
         boost::asio::io_service& io_service,
         bool debug_enabled)
     : m_debug_enabled(debug_enabled)
     , m_io_service(io_service)
+    , m_strand(io_service)
+    , m_call_timer(io_service)
+    , m_call_timer_armed(false)
+    , m_admission_timer(io_service)
+    , m_admission_timer_armed(false)
+    , m_admission_deadline()
+    , m_queued_admissions()
+    , m_send_coalescing()
+    , m_cork_depth(0)
+    , m_send_queue()
+    , m_send_queue_bytes(0)
+    , m_send_batch()
+    , m_flush_timer(io_service)
+    , m_flush_timer_armed(false)
+    , m_send_metrics_mutex()
+    , m_send_metrics()
+    , m_submissions(4096)
+    , m_invocation_replies(4096)
+    , m_drain_scheduled(false)
+    , m_overflow_mutex()
+    , m_overflow()
+    , m_overflowing(false)
     , m_transport()
     , m_request_id(0)
     , m_session_id(0)
     , m_goodbye_sent(false)
     , m_running(false)
+    , m_call_canceling(false)
+    , m_publish_window(0)
+    , m_dispatch_depth(0)
 {
 }
 
@@ -82,7 +112,7 @@ inline boost::future<void> wamp_session::start()
 {
     auto weak_self = std::weak_ptr<wamp_session>(this->shared_from_this());
 
-    m_io_service.dispatch([this, weak_self]() {
+    submit([this, weak_self]() {
         auto shared_self = weak_self.lock();
         if (!shared_self) {
             return;
@@ -109,7 +139,7 @@ inline boost::future<void> wamp_session::stop()
 {
     auto weak_self = std::weak_ptr<wamp_session>(this->shared_from_this());
 
-    m_io_service.dispatch([this, weak_self]() {
+    submit([this, weak_self]() {
         auto shared_self = weak_self.lock();
         if (!shared_self) {
             return;
@@ -148,12 +178,18 @@ inline boost::future<uint64_t> wamp_session::join(
 
     std::unordered_map<std::string, bool> caller_features;
     caller_features["call_timeout"] = true;
+    caller_features["call_canceling"] = true;
+    caller_features["progressive_call_invocations"] = true;
+    caller_features["progressive_call_results"] = true;
     std::unordered_map<std::string, msgpack::object> caller;
     caller["features"] = msgpack::object(caller_features, zone);
     roles["caller"] = msgpack::object(caller, zone);
 
     std::unordered_map<std::string, bool> callee_features;
     callee_features["call_timeout"] = true;
+    callee_features["call_canceling"] = true;
+    callee_features["progressive_call_invocations"] = true;
+    callee_features["progressive_call_results"] = true;
     std::unordered_map<std::string, msgpack::object> callee;
     callee["features"] = msgpack::object(callee_features, zone);
     roles["callee"] = msgpack::object(callee, zone);
@@ -184,7 +220,7 @@ inline boost::future<uint64_t> wamp_session::join(
 
     auto weak_self = std::weak_ptr<wamp_session>(this->shared_from_this());
 
-    m_io_service.dispatch([this, weak_self, message]() {
+    submit([this, weak_self, message]() {
         auto shared_self = weak_self.lock();
         if (!shared_self) {
             return;
@@ -214,7 +250,7 @@ inline boost::future<std::string> wamp_session::leave(const std::string& reason)
 
     auto weak_self = std::weak_ptr<wamp_session>(this->shared_from_this());
 
-    m_io_service.dispatch([this, weak_self, message]() {
+    submit([this, weak_self, message]() {
         auto shared_self = weak_self.lock();
         if (!shared_self) {
             return;
@@ -238,99 +274,218 @@ inline boost::future<std::string> wamp_session::leave(const std::string& reason)
 }
 
 inline boost::future<void> wamp_session::publish(const std::string& topic,const wamp_publish_options& options)
+{
+    boost::promise<void> result;
+    auto future = result.get_future();
+    async_publish(topic, options, wamp_promise_handler<void>(std::move(result)));
+
+    return future;
+}
+
+template <typename List>
+inline boost::future<void> wamp_session::publish(const std::string& topic, const List& arguments,const wamp_publish_options& options)
+{
+    boost::promise<void> result;
+    auto future = result.get_future();
+    async_publish(topic, arguments, options, wamp_promise_handler<void>(std::move(result)));
+
+    return future;
+}
+
+template <typename List, typename Map>
+inline boost::future<void> wamp_session::publish(
+        const std::string& topic, const List& arguments, const Map& kw_arguments,const wamp_publish_options& options)
+{
+    boost::promise<void> result;
+    auto future = result.get_future();
+    async_publish(topic, arguments, kw_arguments, options, wamp_promise_handler<void>(std::move(result)));
+
+    return future;
+}
+
+template <typename CompletionToken>
+inline BOOST_ASIO_INITFN_RESULT_TYPE(CompletionToken, void(std::exception_ptr))
+wamp_session::async_publish(
+        const std::string& topic,
+        const wamp_publish_options& options,
+        CompletionToken&& token)
 {
     uint64_t request_id = ++m_request_id;
 
-    auto message = std::make_shared<wamp_message>(4);
-    message->set_field(0, static_cast<int>(message_type::PUBLISH));
-    message->set_field(1, request_id);
-    message->set_field(2, options);
-    message->set_field(3, topic);
+    wamp_message message(4);
+    message.set_field(0, static_cast<int>(message_type::PUBLISH));
+    message.set_field(1, request_id);
+    message.set_field(2, options);
+    message.set_field(3, topic);
 
-    auto result = std::make_shared<boost::promise<void>>();
-    auto weak_self = std::weak_ptr<wamp_session>(this->shared_from_this());
+    return boost::asio::async_initiate<CompletionToken, void(std::exception_ptr)>(
+            publish_initiation(shared_from_this()), token, request_id, std::move(message), options.acknowledge());
+}
 
-    m_io_service.dispatch([this, weak_self, message, result]() {
-        auto shared_self = weak_self.lock();
-        if (!shared_self) {
-            return;
-        }
+template <typename List, typename CompletionToken>
+inline BOOST_ASIO_INITFN_RESULT_TYPE(CompletionToken, void(std::exception_ptr))
+wamp_session::async_publish(
+        const std::string& topic,
+        const List& arguments,
+        const wamp_publish_options& options,
+        CompletionToken&& token)
+{
+    uint64_t request_id = ++m_request_id;
 
-        try {
-            send_message(std::move(*message));
-            result->set_value();
-        } catch (const std::exception& e) {
-            result->set_exception(boost::copy_exception(e));
-        }
-    });
+    wamp_message message(5);
+    message.set_field(0, static_cast<int>(message_type::PUBLISH));
+    message.set_field(1, request_id);
+    message.set_field(2, options);
+    message.set_field(3, topic);
+    message.set_field(4, arguments);
 
-    return result->get_future();
+    return boost::asio::async_initiate<CompletionToken, void(std::exception_ptr)>(
+            publish_initiation(shared_from_this()), token, request_id, std::move(message), options.acknowledge());
 }
 
-template <typename List>
-inline boost::future<void> wamp_session::publish(const std::string& topic, const List& arguments,const wamp_publish_options& options)
+template <typename List, typename Map, typename CompletionToken>
+inline BOOST_ASIO_INITFN_RESULT_TYPE(CompletionToken, void(std::exception_ptr))
+wamp_session::async_publish(
+        const std::string& topic,
+        const List& arguments,
+        const Map& kw_arguments,
+        const wamp_publish_options& options,
+        CompletionToken&& token)
 {
     uint64_t request_id = ++m_request_id;
 
-    auto message = std::make_shared<wamp_message>(5);
-    message->set_field(0, static_cast<int>(message_type::PUBLISH));
-    message->set_field(1, request_id);
-    message->set_field(2, options);
-    message->set_field(3, topic);
-    message->set_field(4, arguments);
+    wamp_message message(6);
+    message.set_field(0, static_cast<int>(message_type::PUBLISH));
+    message.set_field(1, request_id);
+    message.set_field(2, options);
+    message.set_field(3, topic);
+    message.set_field(4, arguments);
+    message.set_field(5, kw_arguments);
 
-    auto result = std::make_shared<boost::promise<void>>();
-    auto weak_self = std::weak_ptr<wamp_session>(this->shared_from_this());
+    return boost::asio::async_initiate<CompletionToken, void(std::exception_ptr)>(
+            publish_initiation(shared_from_this()), token, request_id, std::move(message), options.acknowledge());
+}
 
-    m_io_service.dispatch([this, weak_self, message, result]() {
-        auto shared_self = weak_self.lock();
-        if (!shared_self) {
-            return;
-        }
+template <typename CompletionToken>
+inline BOOST_ASIO_INITFN_RESULT_TYPE(CompletionToken, void(std::exception_ptr, wamp_publication))
+wamp_session::async_publish_acknowledged(
+        const std::string& topic,
+        const wamp_publish_options& options,
+        CompletionToken&& token)
+{
+    uint64_t request_id = ++m_request_id;
 
-        try {
-            send_message(std::move(*message));
-            result->set_value();
-        } catch (const std::exception& e) {
-            result->set_exception(boost::copy_exception(e));
-        }
-    });
+    wamp_message message(4);
+    message.set_field(0, static_cast<int>(message_type::PUBLISH));
+    message.set_field(1, request_id);
+    message.set_field(2, publish_options_map(options, true));
+    message.set_field(3, topic);
 
-    return result->get_future();
+    return boost::asio::async_initiate<CompletionToken, void(std::exception_ptr, wamp_publication)>(
+            request_initiation<wamp_publish_request>(shared_from_this(), &wamp_session::m_publish_requests),
+            token, request_id, std::move(message));
 }
 
-template <typename List, typename Map>
-inline boost::future<void> wamp_session::publish(
-        const std::string& topic, const List& arguments, const Map& kw_arguments,const wamp_publish_options& options)
+template <typename List, typename CompletionToken>
+inline BOOST_ASIO_INITFN_RESULT_TYPE(CompletionToken, void(std::exception_ptr, wamp_publication))
+wamp_session::async_publish_acknowledged(
+        const std::string& topic,
+        const List& arguments,
+        const wamp_publish_options& options,
+        CompletionToken&& token)
 {
     uint64_t request_id = ++m_request_id;
 
-    auto message = std::make_shared<wamp_message>(6);
-    message->set_field(0, static_cast<int>(message_type::PUBLISH));
-    message->set_field(1, request_id);
-    message->set_field(2, options);
-    message->set_field(3, topic);
-    message->set_field(4, arguments);
-    message->set_field(5, kw_arguments);
+    wamp_message message(5);
+    message.set_field(0, static_cast<int>(message_type::PUBLISH));
+    message.set_field(1, request_id);
+    message.set_field(2, publish_options_map(options, true));
+    message.set_field(3, topic);
+    message.set_field(4, arguments);
 
-    auto result = std::make_shared<boost::promise<void>>();
-    auto weak_self = std::weak_ptr<wamp_session>(this->shared_from_this());
+    return boost::asio::async_initiate<CompletionToken, void(std::exception_ptr, wamp_publication)>(
+            request_initiation<wamp_publish_request>(shared_from_this(), &wamp_session::m_publish_requests),
+            token, request_id, std::move(message));
+}
+
+template <typename List, typename Map, typename CompletionToken>
+inline BOOST_ASIO_INITFN_RESULT_TYPE(CompletionToken, void(std::exception_ptr, wamp_publication))
+wamp_session::async_publish_acknowledged(
+        const std::string& topic,
+        const List& arguments,
+        const Map& kw_arguments,
+        const wamp_publish_options& options,
+        CompletionToken&& token)
+{
+    uint64_t request_id = ++m_request_id;
+
+    wamp_message message(6);
+    message.set_field(0, static_cast<int>(message_type::PUBLISH));
+    message.set_field(1, request_id);
+    message.set_field(2, publish_options_map(options, true));
+    message.set_field(3, topic);
+    message.set_field(4, arguments);
+    message.set_field(5, kw_arguments);
+
+    return boost::asio::async_initiate<CompletionToken, void(std::exception_ptr, wamp_publication)>(
+            request_initiation<wamp_publish_request>(shared_from_this(), &wamp_session::m_publish_requests),
+            token, request_id, std::move(message));
+}
+
+template <typename Range>
+inline boost::future<void> wamp_session::publish_batch(
+        const std::string& topic,
+        const Range& arguments,
+        const wamp_publish_options& options)
+{
+    boost::promise<void> result;
+    auto future = result.get_future();
+    async_publish_batch(topic, arguments, options, wamp_promise_handler<void>(std::move(result)));
+
+    return future;
+}
+
+template <typename Range, typename CompletionToken>
+inline BOOST_ASIO_INITFN_RESULT_TYPE(CompletionToken, void(std::exception_ptr))
+wamp_session::async_publish_batch(
+        const std::string& topic,
+        const Range& arguments,
+        const wamp_publish_options& options,
+        CompletionToken&& token)
+{
+    const auto count = static_cast<uint64_t>(std::distance(std::begin(arguments), std::end(arguments)));
+    uint64_t request_id = m_request_id.fetch_add(count);
+    const auto options_map = publish_options_map(options, false);
+
+    std::vector<wamp_message> messages;
+    messages.reserve(count);
+    for (const auto& element : arguments) {
+        messages.emplace_back(5);
+        wamp_message& message = messages.back();
+        message.set_field(0, static_cast<int>(message_type::PUBLISH));
+        message.set_field(1, ++request_id);
+        message.set_field(2, options_map);
+        message.set_field(3, topic);
+        message.set_field(4, element);
+    }
 
-    m_io_service.dispatch([this, weak_self, message, result]() {
+    return boost::asio::async_initiate<CompletionToken, void(std::exception_ptr)>(
+            publish_initiation(shared_from_this()), token, std::move(messages));
+}
+
+inline void wamp_session::set_publish_window(std::size_t window)
+{
+    auto weak_self = std::weak_ptr<wamp_session>(this->shared_from_this());
+    submit([weak_self, window]() {
         auto shared_self = weak_self.lock();
         if (!shared_self) {
             return;
         }
 
-        try {
-            send_message(std::move(*message));
-            result->set_value();
-        } catch (const std::exception& e) {
-            result->set_exception(boost::copy_exception(e));
-        }
+        // A wider window lets held back publications go right away.
+        shared_self->m_publish_window = window;
+        shared_self->release_publication_slots();
     });
-
-    return result->get_future();
 }
 
 inline boost::future<wamp_subscription> wamp_session::subscribe(
@@ -338,32 +493,79 @@ inline boost::future<wamp_subscription> wamp_session::subscribe(
         const wamp_event_handler& handler,
         const wamp_subscribe_options& options)
 {
-    uint64_t request_id = ++m_request_id;
+    boost::promise<wamp_subscription> result;
+    auto future = result.get_future();
+    async_subscribe(topic, handler, options, wamp_promise_handler<wamp_subscription>(std::move(result)));
 
-    auto message = std::make_shared<wamp_message>(4);
-    message->set_field(0, static_cast<int>(message_type::SUBSCRIBE));
-    message->set_field(1, request_id);
-    message->set_field(2, options);
-    message->set_field(3, topic);
+    return future;
+}
 
-    auto weak_self = std::weak_ptr<wamp_session>(this->shared_from_this());
-    auto subscribe_request = std::make_shared<wamp_subscribe_request>(handler);
+template <typename Executor>
+inline boost::future<wamp_subscription> wamp_session::subscribe(
+        const std::string& topic,
+        const wamp_event_handler& handler,
+        const Executor& executor,
+        const wamp_subscribe_options& options,
+        typename std::enable_if<boost::asio::is_executor<Executor>::value>::type*)
+{
+    return subscribe(topic, make_executor_event_handler(executor, handler), options);
+}
 
-    m_io_service.dispatch([this, weak_self, message, request_id, subscribe_request]() {
-        auto shared_self = weak_self.lock();
-        if (!shared_self) {
-            return;
-        }
+template <typename Executor>
+inline boost::future<wamp_subscription> wamp_session::subscribe(
+        const std::string& topic,
+        const wamp_event_handler& handler,
+        const Executor& executor,
+        const wamp_conflation& conflation,
+        const wamp_subscribe_options& options,
+        typename std::enable_if<boost::asio::is_executor<Executor>::value>::type*)
+{
+    return subscribe(topic, make_conflating_event_handler(executor, handler, conflation), options);
+}
 
-        try {
-            send_message(std::move(*message));
-            m_subscribe_requests.emplace(request_id, subscribe_request);
-        } catch (const std::exception& e) {
-            subscribe_request->response().set_exception(boost::copy_exception(e));
-        }
-    });
+inline boost::future<wamp_subscription> wamp_session::subscribe_batch(
+        const std::string& topic,
+        const wamp_batch_event_handler& handler,
+        const wamp_batch_options& batch_options,
+        const wamp_subscribe_options& options)
+{
+    const bool debug_enabled = m_debug_enabled;
+    auto batcher = std::make_shared<wamp_batcher<wamp_event>>(m_io_service, m_strand, batch_options,
+            [handler, debug_enabled](std::vector<wamp_event>&& events) {
+                try {
+                    handler(span<const wamp_event>(events.data(), events.size()));
+                } catch (...) {
+                    if (debug_enabled) {
+                        std::cerr << "Warning: event handler threw exception" << std::endl;
+                    }
+                }
+            });
+
+    wamp_event_handler collect = [batcher](const wamp_event& event) {
+        batcher->add(event);
+    };
+    return subscribe(topic, collect, options);
+}
+
+template <typename CompletionToken>
+inline BOOST_ASIO_INITFN_RESULT_TYPE(CompletionToken, void(std::exception_ptr, wamp_subscription))
+wamp_session::async_subscribe(
+        const std::string& topic,
+        const wamp_event_handler& handler,
+        const wamp_subscribe_options& options,
+        CompletionToken&& token)
+{
+    uint64_t request_id = ++m_request_id;
 
-    return subscribe_request->response().get_future();
+    wamp_message message(4);
+    message.set_field(0, static_cast<int>(message_type::SUBSCRIBE));
+    message.set_field(1, request_id);
+    message.set_field(2, options);
+    message.set_field(3, topic);
+
+    return boost::asio::async_initiate<CompletionToken, void(std::exception_ptr, wamp_subscription)>(
+            request_initiation<wamp_subscribe_request>(shared_from_this(), &wamp_session::m_subscribe_requests),
+            token, request_id, std::move(message), handler);
 }
 
 inline boost::future<void> wamp_session::unsubscribe(const wamp_subscription& subscription)
@@ -377,8 +579,9 @@ inline boost::future<void> wamp_session::unsubscribe(const wamp_subscription& su
 
     auto weak_self = std::weak_ptr<wamp_session>(this->shared_from_this());
     auto unsubscribe_request = std::make_shared<wamp_unsubscribe_request>(subscription);
+    auto future = unsubscribe_request->response().get_future();
 
-    m_io_service.dispatch([this, weak_self, message, request_id, unsubscribe_request]() {
+    submit([this, weak_self, message, request_id, unsubscribe_request]() {
         auto shared_self = weak_self.lock();
         if (!shared_self) {
             return;
@@ -386,117 +589,164 @@ inline boost::future<void> wamp_session::unsubscribe(const wamp_subscription& su
 
         try {
             send_message(std::move(*message));
-            m_unsubscribe_requests.emplace(request_id, unsubscribe_request);
+            m_unsubscribe_requests.emplace(request_id, std::move(*unsubscribe_request));
         } catch (const std::exception& e) {
             unsubscribe_request->response().set_exception(boost::copy_exception(e));
         }
     });
 
-    return unsubscribe_request->response().get_future();
+    return future;
 }
 
 inline boost::future<wamp_call_result> wamp_session::call(
         const std::string& procedure,
         const wamp_call_options& options)
 {
-    uint64_t request_id = ++m_request_id;
+    boost::promise<wamp_call_result> result;
+    auto future = result.get_future();
+    async_call(procedure, options, wamp_promise_handler<wamp_call_result>(std::move(result)));
 
-    auto message = std::make_shared<wamp_message>(4);
-    message->set_field(0, static_cast<int>(message_type::CALL));
-    message->set_field(1, request_id);
-    message->set_field(2, options);
-    message->set_field(3, procedure);
-
-    auto weak_self = std::weak_ptr<wamp_session>(this->shared_from_this());
-    auto call = std::make_shared<wamp_call>();
-
-    m_io_service.dispatch([this, weak_self, message, request_id, call]() {
-        auto shared_self = weak_self.lock();
-        if (!shared_self) {
-            return;
-        }
+    return future;
+}
 
-        try {
-            send_message(std::move(*message));
-            m_calls.emplace(request_id, call);
-        } catch (const std::exception& e) {
-            call->result().set_exception(boost::copy_exception(e));
-        }
-    });
+template<typename List>
+inline boost::future<wamp_call_result> wamp_session::call(
+        const std::string& procedure,
+        const List& arguments,
+        const wamp_call_options& options)
+{
+    boost::promise<wamp_call_result> result;
+    auto future = result.get_future();
+    async_call(procedure, arguments, options, wamp_promise_handler<wamp_call_result>(std::move(result)));
 
-    return call->result().get_future();
+    return future;
 }
 
-template<typename List>
+template<typename List, typename Map>
 inline boost::future<wamp_call_result> wamp_session::call(
         const std::string& procedure,
         const List& arguments,
+        const Map& kw_arguments,
         const wamp_call_options& options)
 {
-    uint64_t request_id = ++m_request_id;
+    boost::promise<wamp_call_result> result;
+    auto future = result.get_future();
+    async_call(procedure, arguments, kw_arguments, options,
+            wamp_promise_handler<wamp_call_result>(std::move(result)));
 
-    auto message = std::make_shared<wamp_message>(5);
-    message->set_field(0, static_cast<int>(message_type::CALL));
-    message->set_field(1, request_id);
-    message->set_field(2, options);
-    message->set_field(3, procedure);
-    message->set_field(4, arguments);
+    return future;
+}
 
-    auto weak_self = std::weak_ptr<wamp_session>(this->shared_from_this());
-    auto call = std::make_shared<wamp_call>();
+template <typename CompletionToken>
+inline BOOST_ASIO_INITFN_RESULT_TYPE(CompletionToken, void(std::exception_ptr, wamp_call_result))
+wamp_session::async_call(
+        const std::string& procedure,
+        const wamp_call_options& options,
+        CompletionToken&& token)
+{
+    uint64_t request_id = ++m_request_id;
 
-    m_io_service.dispatch([this, weak_self, message, request_id, call]() {
-        auto shared_self = weak_self.lock();
-        if (!shared_self) {
-            return;
-        }
+    wamp_message message(4);
+    message.set_field(0, static_cast<int>(message_type::CALL));
+    message.set_field(1, request_id);
+    message.set_field(2, options);
+    message.set_field(3, procedure);
 
-        try {
-            send_message(std::move(*message));
-            m_calls.emplace(request_id, call);
-        } catch (const std::exception& e) {
-            call->result().set_exception(boost::copy_exception(e));
-        }
-    });
+    return boost::asio::async_initiate<CompletionToken, void(std::exception_ptr, wamp_call_result)>(
+            request_initiation<wamp_call>(shared_from_this(), &wamp_session::m_calls),
+            token, request_id, std::move(message),
+            options.timeout(), options.handle(), options.progress_handler());
+}
 
-    return call->result().get_future();
+template <typename List, typename CompletionToken>
+inline BOOST_ASIO_INITFN_RESULT_TYPE(CompletionToken, void(std::exception_ptr, wamp_call_result))
+wamp_session::async_call(
+        const std::string& procedure,
+        const List& arguments,
+        const wamp_call_options& options,
+        CompletionToken&& token)
+{
+    uint64_t request_id = ++m_request_id;
+
+    wamp_message message(5);
+    message.set_field(0, static_cast<int>(message_type::CALL));
+    message.set_field(1, request_id);
+    message.set_field(2, options);
+    message.set_field(3, procedure);
+    message.set_field(4, arguments);
+
+    return boost::asio::async_initiate<CompletionToken, void(std::exception_ptr, wamp_call_result)>(
+            request_initiation<wamp_call>(shared_from_this(), &wamp_session::m_calls),
+            token, request_id, std::move(message),
+            options.timeout(), options.handle(), options.progress_handler());
 }
 
-template<typename List, typename Map>
-inline boost::future<wamp_call_result> wamp_session::call(
+template <typename List, typename Map, typename CompletionToken>
+inline BOOST_ASIO_INITFN_RESULT_TYPE(CompletionToken, void(std::exception_ptr, wamp_call_result))
+wamp_session::async_call(
         const std::string& procedure,
         const List& arguments,
         const Map& kw_arguments,
+        const wamp_call_options& options,
+        CompletionToken&& token)
+{
+    uint64_t request_id = ++m_request_id;
+
+    wamp_message message(6);
+    message.set_field(0, static_cast<int>(message_type::CALL));
+    message.set_field(1, request_id);
+    message.set_field(2, options);
+    message.set_field(3, procedure);
+    message.set_field(4, arguments);
+    message.set_field(5, kw_arguments);
+
+    return boost::asio::async_initiate<CompletionToken, void(std::exception_ptr, wamp_call_result)>(
+            request_initiation<wamp_call>(shared_from_this(), &wamp_session::m_calls),
+            token, request_id, std::move(message),
+            options.timeout(), options.handle(), options.progress_handler());
+}
+
+inline wamp_progressive_call wamp_session::open_call(
+        const std::string& procedure,
         const wamp_call_options& options)
 {
     uint64_t request_id = ++m_request_id;
 
-    auto message = std::make_shared<wamp_message>(6);
-    message->set_field(0, static_cast<int>(message_type::CALL));
-    message->set_field(1, request_id);
-    message->set_field(2, options);
-    message->set_field(3, procedure);
-    message->set_field(4, arguments);
-    message->set_field(5, kw_arguments);
+    auto result = std::make_shared<boost::promise<wamp_call_result>>();
+    auto future = result->get_future();
 
-    auto weak_self = std::weak_ptr<wamp_session>(this->shared_from_this());
-    auto call = std::make_shared<wamp_call>();
+    auto weak_this = std::weak_ptr<wamp_session>(this->shared_from_this());
+    const std::chrono::milliseconds timeout = options.timeout();
+    const wamp_call_handle handle = options.handle();
+    const wamp_progress_handler progress_handler = options.progress_handler();
 
-    m_io_service.dispatch([this, weak_self, message, request_id, call]() {
-        auto shared_self = weak_self.lock();
-        if (!shared_self) {
+    auto send_chunk_fn = [weak_this, request_id, result, timeout, handle, progress_handler] (
+            const std::shared_ptr<wamp_message>& message, bool first) {
+        auto shared_this = weak_this.lock();
+        if (!shared_this) {
             return;
         }
 
-        try {
-            send_message(std::move(*message));
-            m_calls.emplace(request_id, call);
-        } catch (const std::exception& e) {
-            call->result().set_exception(boost::copy_exception(e));
+        // The first chunk makes the call pending like any other.
+        if (first) {
+            wamp_promise_handler<wamp_call_result> handler(std::move(*result));
+            boost::asio::async_initiate<wamp_promise_handler<wamp_call_result>,
+                    void(std::exception_ptr, wamp_call_result)>(
+                    request_initiation<wamp_call>(shared_this, &wamp_session::m_calls),
+                    handler, request_id, std::move(*message), timeout, handle, progress_handler);
+            return;
         }
-    });
 
-    return call->result().get_future();
+        shared_this->submit([weak_this, request_id, message] {
+            auto shared_this = weak_this.lock();
+            if (!shared_this) {
+                return;
+            }
+            shared_this->send_call_chunk(request_id, std::move(*message));
+        });
+    };
+
+    return wamp_progressive_call(procedure, options, request_id, std::move(send_chunk_fn), std::move(future));
 }
 
 inline boost::future<wamp_registration> wamp_session::provide(
@@ -504,65 +754,193 @@ inline boost::future<wamp_registration> wamp_session::provide(
         const wamp_procedure& procedure,
         const provide_options& options)
 {
-    uint64_t request_id = ++m_request_id;
-
-    auto message = std::make_shared<wamp_message>(4);
-    message->set_field(0, static_cast<int>(message_type::REGISTER));
-    message->set_field(1, request_id);
-    message->set_field(2, options);
-    message->set_field(3, name);
-
-    auto weak_self = std::weak_ptr<wamp_session>(this->shared_from_this());
-    auto register_request = std::make_shared<wamp_register_request>(procedure);
+    return provide(name, procedure, invocation_pool(), options);
+}
 
-    m_io_service.dispatch([this, weak_self, message, request_id, register_request]() {
-        auto shared_self = weak_self.lock();
-        if (!shared_self) {
-            return;
-        }
+inline boost::future<wamp_registration> wamp_session::provide(
+        const std::string& name,
+        const wamp_procedure& procedure,
+        const std::shared_ptr<wamp_invocation_executor>& pool,
+        const provide_options& options)
+{
+    if (!pool) {
+        boost::promise<wamp_registration> result;
+        auto future = result.get_future();
+        async_provide(name, procedure, options, wamp_promise_handler<wamp_registration>(std::move(result)));
+        return future;
+    }
 
-        try {
-            send_message(std::move(*message));
-            m_register_requests.emplace(request_id, register_request);
-        } catch (const std::exception& e) {
-            register_request->response().set_exception(boost::copy_exception(e));
-        }
-    });
+    return provide(name, pooled_procedure(pool, procedure), std::shared_ptr<wamp_invocation_executor>(), options);
+}
 
-    return register_request->response().get_future();
+inline void wamp_session::set_invocation_pool(const std::shared_ptr<wamp_invocation_executor>& pool)
+{
+    std::lock_guard<std::mutex> lock(m_invocation_pool_mutex);
+    m_invocation_pool = pool;
 }
 
-inline boost::future<void> wamp_session::unprovide(const wamp_registration& registration)
+inline std::shared_ptr<wamp_invocation_executor> wamp_session::invocation_pool() const
 {
-    uint64_t request_id = ++m_request_id;
+    std::lock_guard<std::mutex> lock(m_invocation_pool_mutex);
+    return m_invocation_pool;
+}
 
-	auto message = std::make_shared<wamp_message>(3);
-	message->set_field(0, static_cast<int>(message_type::UNREGISTER));
-	message->set_field(1, request_id);
-	message->set_field(2, registration.id());
+inline boost::future<wamp_registration> wamp_session::provide(
+        const std::string& name,
+        const wamp_procedure& procedure,
+        const wamp_admission_control& admission,
+        const provide_options& options)
+{
+    // Admission runs on the session, so rejected invocations never reach the pool.
+    auto pool = invocation_pool();
+    const wamp_procedure admitted = pool ? pooled_procedure(pool, procedure) : procedure;
+
+    boost::promise<wamp_registration> result;
+    auto future = result.get_future();
+    async_provide(name, admitted, admission, options, wamp_promise_handler<wamp_registration>(std::move(result)));
+    return future;
+}
 
-	auto weak_self = std::weak_ptr<wamp_session>(this->shared_from_this());
-	auto unregister_request = std::make_shared<wamp_unregister_request>(registration);
+inline boost::future<wamp_registration> wamp_session::provide_batch(
+        const std::string& name,
+        const wamp_batch_procedure& procedure,
+        const wamp_batch_options& batch_options,
+        const provide_options& options)
+{
+    auto pool = invocation_pool();
+    auto batcher = std::make_shared<wamp_batcher<wamp_invocation>>(m_io_service, m_strand, batch_options,
+            [procedure, pool](std::vector<wamp_invocation>&& invocations) {
+                if (!pool) {
+                    invoke_batch_procedure(procedure, invocations);
+                    return;
+                }
 
-	m_io_service.dispatch([this, weak_self, message, request_id, unregister_request]() {
-		auto shared_self = weak_self.lock();
-		if (!shared_self) {
-			return;
-		}
+                const wamp_invocation first = invocations.front();
+                auto batch = std::make_shared<std::vector<wamp_invocation>>(std::move(invocations));
+                pool->post(first, [procedure, batch]() {
+                    invoke_batch_procedure(procedure, *batch);
+                });
+            });
 
-		try {
-			send_message(std::move(*message));
-			m_unregister_requests.emplace(request_id, unregister_request);
-		}
-		catch (const std::exception& e) {
-			unregister_request->response().set_exception(boost::copy_exception(e));
-		}
-	});
+    // Collecting happens on the session, only whole batches go to the pool.
+    wamp_procedure collect = [batcher](const wamp_invocation& invocation) {
+        batcher->add(invocation);
+    };
+    return provide(name, collect, std::shared_ptr<wamp_invocation_executor>(), options);
+}
 
-	return unregister_request->response().get_future();
+template <typename CompletionToken>
+inline BOOST_ASIO_INITFN_RESULT_TYPE(CompletionToken, void(std::exception_ptr, wamp_registration))
+wamp_session::async_provide(
+        const std::string& name,
+        const wamp_procedure& procedure,
+        const provide_options& options,
+        CompletionToken&& token)
+{
+    return async_provide(name, procedure, wamp_admission_control(), options, std::forward<CompletionToken>(token));
 }
 
-inline boost::future<wamp_authenticate> wamp_session::on_challenge(const wamp_challenge& /*challenge*/)
+template <typename CompletionToken>
+inline BOOST_ASIO_INITFN_RESULT_TYPE(CompletionToken, void(std::exception_ptr, wamp_registration))
+wamp_session::async_provide(
+        const std::string& name,
+        const wamp_procedure& procedure,
+        const wamp_admission_control& admission,
+        const provide_options& options,
+        CompletionToken&& token)
+{
+    uint64_t request_id = ++m_request_id;
+
+    wamp_message message(4);
+    message.set_field(0, static_cast<int>(message_type::REGISTER));
+    message.set_field(1, request_id);
+    message.set_field(2, options);
+    message.set_field(3, name);
+
+    return boost::asio::async_initiate<CompletionToken, void(std::exception_ptr, wamp_registration)>(
+            request_initiation<wamp_register_request>(shared_from_this(), &wamp_session::m_register_requests),
+            token, request_id, std::move(message), procedure, admission);
+}
+
+template <typename Signature, typename... Params>
+inline typed_call_future<Signature, sizeof...(Params)> wamp_session::typed_call(
+        const std::string& procedure,
+        Params&&... params)
+{
+    return typed_call<Signature>(procedure, wamp_call_options(), std::forward<Params>(params)...);
+}
+
+template <typename Signature, typename... Params>
+inline typed_call_future<Signature, sizeof...(Params)> wamp_session::typed_call(
+        const std::string& procedure,
+        const wamp_call_options& options,
+        Params&&... params)
+{
+    using result_type = typename wamp_signature<Signature>::result_type;
+    using arguments_type = typename wamp_signature<Signature>::arguments_type;
+
+    static_assert(std::is_constructible<arguments_type, Params&&...>::value,
+            "the arguments do not convert to the parameters of the signature");
+
+    const arguments_type arguments(std::forward<Params>(params)...);
+    return call(procedure, arguments, options).then(boost::launch::sync,
+            [](boost::future<wamp_call_result> result) {
+                return typed_result<result_type>::decode(result.get());
+            });
+}
+
+template <typename Signature, typename Function>
+inline boost::future<wamp_registration> wamp_session::provide(
+        const std::string& uri,
+        Function&& function,
+        const provide_options& options)
+{
+    return provide(uri, make_typed_procedure<Signature>(std::forward<Function>(function)), options);
+}
+
+#if defined(BOOST_ASIO_HAS_CO_AWAIT)
+template <typename Function>
+inline coroutine_provide_future<Function> wamp_session::provide(
+        const std::string& uri,
+        Function&& function,
+        const provide_options& options)
+{
+    return provide(uri, make_coroutine_procedure(m_io_service.get_executor(), std::forward<Function>(function)), options);
+}
+#endif
+
+inline boost::future<void> wamp_session::unprovide(const wamp_registration& registration)
+{
+    uint64_t request_id = ++m_request_id;
+
+	auto message = std::make_shared<wamp_message>(3);
+	message->set_field(0, static_cast<int>(message_type::UNREGISTER));
+	message->set_field(1, request_id);
+	message->set_field(2, registration.id());
+
+	auto weak_self = std::weak_ptr<wamp_session>(this->shared_from_this());
+	auto unregister_request = std::make_shared<wamp_unregister_request>(registration);
+	auto future = unregister_request->response().get_future();
+
+	submit([this, weak_self, message, request_id, unregister_request]() {
+		auto shared_self = weak_self.lock();
+		if (!shared_self) {
+			return;
+		}
+
+		try {
+			send_message(std::move(*message));
+			m_unregister_requests.emplace(request_id, std::move(*unregister_request));
+		}
+		catch (const std::exception& e) {
+			unregister_request->response().set_exception(boost::copy_exception(e));
+		}
+	});
+
+	return future;
+}
+
+inline boost::future<wamp_authenticate> wamp_session::on_challenge(const wamp_challenge& /*challenge*/)
 {
     // a dummy implementation
     boost::promise<wamp_authenticate> dummy;
@@ -590,10 +968,9 @@ inline void wamp_session::on_attach(const std::shared_ptr<wamp_transport>& trans
 
 inline void wamp_session::on_detach(bool /*was_clean*/, const std::string& /*reason*/)
 {
-    // FIXME: We should be deferring this operation to the io service. This
-    //        will almost certainly require us to return a future here to
-    //        all the caller to sync up with the actual detaching of the
-    //        transport.
+    // FIXME: The transport is released on the strand below, but the caller
+    //        cannot sync up with that yet. This will almost certainly
+    //        require us to return a future here.
 
     if (!m_transport) {
         throw protocol_error("Transport already detached from session");
@@ -608,10 +985,48 @@ inline void wamp_session::on_detach(bool /*was_clean*/, const std::string& /*rea
     //        session.
     assert(!m_running);
 
-    m_transport.reset();
+    // The send queue and its timer belong to the strand, and operations
+    // submitted before still get to use the transport, so it is released on
+    // the strand as well. Messages still held back are lost with it.
+    auto weak_self = std::weak_ptr<wamp_session>(this->shared_from_this());
+    submit([this, weak_self]() {
+        auto shared_self = weak_self.lock();
+        if (!shared_self) {
+            return;
+        }
+
+        m_send_queue.clear();
+        m_send_queue_bytes = 0;
+        m_flush_timer.cancel();
+        m_flush_timer_armed = false;
+
+        m_transport.reset();
+    });
 }
 
 inline void wamp_session::on_message(wamp_message&& message)
+{
+    if (m_strand.running_in_this_thread()) {
+        process_message(std::move(message));
+        return;
+    }
+
+    // The transport delivers from its own strand; the message is processed on
+    // the session strand, inline when the strand is free, while the transport
+    // goes on decoding the next one.
+    auto weak_self = std::weak_ptr<wamp_session>(this->shared_from_this());
+    auto shared_message = std::make_shared<wamp_message>(std::move(message));
+    m_strand.dispatch([weak_self, shared_message]() {
+        auto shared_self = weak_self.lock();
+        if (!shared_self) {
+            return;
+        }
+
+        shared_self->process_message(std::move(*shared_message));
+    });
+}
+
+inline void wamp_session::process_message(wamp_message&& message)
 {
     // FIXME: Move this check into the transport
     //if (obj.type != msgpack::type::ARRAY) {
@@ -654,7 +1069,7 @@ inline void wamp_session::on_message(wamp_message&& message)
         case message_type::PUBLISH:
             throw protocol_error("received PUBLISH message unexpected for WAMP client roles");
         case message_type::PUBLISHED:
-            // FIXME
+            process_published(std::move(message));
             break;
         case message_type::SUBSCRIBE:
             throw protocol_error("received SUBSCRIBE message unexpected for WAMP client roles");
@@ -690,7 +1105,8 @@ inline void wamp_session::on_message(wamp_message&& message)
             process_invocation(std::move(message));
             break;
         case message_type::INTERRUPT:
-            throw protocol_error("received INTERRUPT message - not implemented");
+            process_interrupt(std::move(message));
+            break;
         case message_type::YIELD:
             throw protocol_error("received YIELD message unexpected for WAMP client roles");
     }
@@ -818,7 +1234,7 @@ inline void wamp_session::process_challenge(wamp_message&& message)
             message->set_field(2, std::unordered_map<int, int>() /* No Extra/Dict */);
 
             auto weak_self = std::weak_ptr<wamp_session>(this->shared_from_this());
-            m_io_service.dispatch([this, weak_self, message, context_response]() {
+            submit([this, weak_self, message, context_response]() {
                 auto shared_self = weak_self.lock();
                 if (!shared_self) {
                     return;
@@ -848,6 +1264,7 @@ inline void wamp_session::process_challenge(wamp_message&& message)
 inline void wamp_session::process_welcome(wamp_message&& message)
 {
     m_session_id = message.field<uint64_t>(1);
+    m_call_canceling = has_role_feature(message.field(2), "dealer", "call_canceling");
     message.field(2).convert(m_welcome_details);
     m_session_join.set_value(m_session_id);
 }
@@ -974,24 +1391,22 @@ inline void wamp_session::process_error(wamp_message&& message)
                 //
                 // process CALL ERROR
                 //
-                auto call_itr = m_calls.find(request_id);
+                auto call = take_call(request_id);
 
-                if (call_itr != m_calls.end()) {
+                if (call) {
                     // FIXME: Forward all error info.
-                    call_itr->second->result().set_exception(boost::copy_exception(std::runtime_error(error)));
-                    m_calls.erase(call_itr);
-                } else {
+                    call->set_exception(std::make_exception_ptr(std::runtime_error(error)));
+                } else if (!forget_canceled_call(request_id)) {
                     throw protocol_error("bogus ERROR message for non-pending CALL request ID: " + error);
                 }
             }
             break;
         case message_type::REGISTER:
             {
-                auto reg_itr = m_register_requests.find(request_id);
-                if (reg_itr != m_register_requests.end())
+                auto register_request = m_register_requests.take(request_id);
+                if (register_request)
                 {
-                    reg_itr->second->response().set_exception(boost::copy_exception(std::runtime_error(error)));
-                    m_register_requests.erase(reg_itr);
+                    register_request->set_exception(std::make_exception_ptr(std::runtime_error(error)));
                 } else {
                     throw protocol_error("bogus ERROR message for non-pending REGISTER request ID: " + error);
                 }
@@ -999,11 +1414,10 @@ inline void wamp_session::process_error(wamp_message&& message)
             break;
         case message_type::UNREGISTER:
             {
-                auto unreg_itr = m_unregister_requests.find(request_id);
-                if (unreg_itr != m_unregister_requests.end())
+                auto unregister_request = m_unregister_requests.take(request_id);
+                if (unregister_request)
                 {
-                   unreg_itr->second->response().set_exception(boost::copy_exception(std::runtime_error(error)));
-                   m_unregister_requests.erase(unreg_itr);
+                   unregister_request->response().set_exception(boost::copy_exception(std::runtime_error(error)));
                 } else {
                     throw protocol_error("bogus ERROR message for non-pending UNREGISTER request ID: " + error);
                 }
@@ -1011,19 +1425,23 @@ inline void wamp_session::process_error(wamp_message&& message)
             break;
         case message_type::PUBLISH:
             {
-                //TODO: there's currently no way to get to the future returned by the publish function
-                // but there needs to be something more sensibly then just propagating the error to the
-                // function running the io_service
-                throw protocol_error("Received ERROR for a PUBLISH request: " + error);
+                // Only acknowledged publications get an ERROR.
+                auto publish_request = m_publish_requests.take(request_id);
+                if (publish_request)
+                {
+                    publish_request->set_exception(std::make_exception_ptr(std::runtime_error(error)));
+                    release_publication_slots();
+                } else {
+                    throw protocol_error("bogus ERROR message for non-pending PUBLISH request ID: " + error);
+                }
             }
             break;
         case message_type::SUBSCRIBE:
             {
-                auto sub_itr = m_subscribe_requests.find(request_id);
-                if (sub_itr != m_subscribe_requests.end())
+                auto subscribe_request = m_subscribe_requests.take(request_id);
+                if (subscribe_request)
                 {
-                    sub_itr->second->response().set_exception(boost::copy_exception(std::runtime_error(error)));
-                    m_subscribe_requests.erase(sub_itr);
+                    subscribe_request->set_exception(std::make_exception_ptr(std::runtime_error(error)));
                 } else {
                     throw protocol_error("bogus ERROR message for non-pending SUBSCRIBE request ID: " + error);
                 }
@@ -1031,11 +1449,10 @@ inline void wamp_session::process_error(wamp_message&& message)
             break;
         case message_type::UNSUBSCRIBE:
             {
-                auto unsub_itr = m_unsubscribe_requests.find(request_id);
-                if (unsub_itr != m_unsubscribe_requests.end())
+                auto unsubscribe_request = m_unsubscribe_requests.take(request_id);
+                if (unsubscribe_request)
                 {
-                    unsub_itr->second->response().set_exception(boost::copy_exception(std::runtime_error(error)));
-                    m_unsubscribe_requests.erase(unsub_itr);
+                    unsubscribe_request->response().set_exception(boost::copy_exception(std::runtime_error(error)));
                 } else {
                     throw protocol_error("bogus ERROR message for non-pending UNSUBSCRIBE request ID: " + error);
                 }
@@ -1068,11 +1485,37 @@ inline void wamp_session::process_invocation(wamp_message&& message)
     }
     uint64_t registration_id = message.field<uint64_t>(2);
 
-    auto procedure_itr = m_procedures.find(registration_id);
-    if (procedure_itr != m_procedures.end()) {
-        if (!message.is_field_type(3, msgpack::type::MAP)) {
-            throw protocol_error("INVOCATION.Details must be a map");
+    if (!message.is_field_type(3, msgpack::type::MAP)) {
+        throw protocol_error("INVOCATION.Details must be a map");
+    }
+    const bool progress = value_for_key_or<bool>(message.field(3), "progress", false);
+
+    // Further chunks of arguments of a progressive call invocation
+    const std::weak_ptr<wamp_invocation_impl>* stream = m_invocation_streams.find(request_id);
+    if (stream) {
+        wamp_invocation invocation = stream->lock();
+        if (!progress) {
+            m_invocation_streams.erase(request_id);
+        }
+
+        // Chunks for invocations replied to or interrupted already are dropped.
+        if (invocation && m_invocations.find(request_id)) {
+            if (message.size() > 4 && !message.is_field_type(4, msgpack::type::ARRAY)) {
+                throw protocol_error("INVOCATION.Arguments must be an array/vector");
+            }
+            if (message.size() > 5 && !message.is_field_type(5, msgpack::type::MAP)) {
+                throw protocol_error("INVOCATION.KwArguments must be a map");
+            }
+            const msgpack::object details = message.field(3);
+            const msgpack::object arguments = message.size() > 4 ? message.field(4) : EMPTY_ARGUMENTS;
+            const msgpack::object kw_arguments = message.size() > 5 ? message.field(5) : EMPTY_KW_ARGUMENTS;
+            invocation->push_arguments(std::move(message.zone()), details, arguments, kw_arguments);
         }
+        return;
+    }
+
+    const wamp_procedure* procedure = m_procedures.find(registration_id);
+    if (procedure) {
 
         wamp_invocation invocation = std::make_shared<wamp_invocation_impl>();
         invocation->set_request_id(request_id);
@@ -1093,54 +1536,269 @@ inline void wamp_session::process_invocation(wamp_message&& message)
 
         invocation->set_zone(std::move(message.zone()));
 
-        auto weak_this = std::weak_ptr<wamp_session>(this->shared_from_this());
+        m_invocations.emplace(request_id, invocation);
+        if (progress) {
+            m_invocation_streams.emplace(request_id, invocation);
+        }
 
-        auto send_result_fn = [weak_this] (const std::shared_ptr<wamp_message>& message) {
-            // Make sure the session still exists, since the invocation could run
-            // on a different thread.
-            auto shared_this = weak_this.lock();
-            if (!shared_this) {
-                return; // FIXME: or throw exception?
-            }
+        // Invocations beyond the limits of the registration queue or are shed.
+        std::shared_ptr<wamp_admission_slot> slot;
+        const wamp_admission_control* admission = m_admission_controls.find(registration_id);
+        if (admission) {
+            auto weak_this = std::weak_ptr<wamp_session>(this->shared_from_this());
+            const std::string reject_uri = admission->reject_uri();
 
-            // Send to the io_service thread, and make sure the session still exists (again).
-            shared_this->m_io_service.dispatch([weak_this, message] {
+            auto start = [weak_this, registration_id, request_id, invocation](
+                    const std::shared_ptr<wamp_admission_slot>& slot) {
                 auto shared_this = weak_this.lock();
                 if (!shared_this) {
-                    return; // FIXME: or throw exception?
+                    return;
                 }
-                shared_this->send_message(std::move(*message));
-            });
-        };
 
-        invocation->set_send_result_fn(std::move(send_result_fn));
+                // A slot frees up wherever an invocation replies, so go back to the
+                // session strand; posting also keeps synchronous replies from nesting.
+                shared_this->m_strand.post([weak_this, registration_id, request_id, invocation, slot]() {
+                    auto shared_this = weak_this.lock();
+                    if (shared_this) {
+                        shared_this->start_admitted_invocation(registration_id, request_id, invocation, slot);
+                    }
+                });
+            };
+            auto reject = [invocation, reject_uri]() {
+                if (invocation->sendable()) {
+                    invocation->error(reject_uri);
+                }
+            };
 
-        try {
-            if (m_debug_enabled) {
-                std::cerr << "Invoking procedure registered under " << registration_id << std::endl;
+            auto decision = admission->admit(std::move(start), std::move(reject), slot);
+            if (decision != wamp_admission_control::decision::start) {
+                invocation->set_send_result_fn(invocation_reply_fn(request_id, nullptr));
+                if (decision == wamp_admission_control::decision::rejected) {
+                    invocation->error(reject_uri);
+                } else {
+                    arm_admission_timer(*admission);
+                }
+                return;
             }
-            procedure_itr->second(invocation);
         }
 
-        // FIXME: implement Autobahn-specific exception with error URI
-        catch (const std::exception& e) {
-            // we can at least describe the error with e.what()
-            //
+        invocation->set_send_result_fn(invocation_reply_fn(request_id, slot));
+
+        dispatch_guard guard(*this);
+        if (m_debug_enabled) {
+            std::cerr << "Invoking procedure registered under " << registration_id << std::endl;
+        }
+        invoke_procedure(*procedure, invocation);
+    } else {
+        throw protocol_error("bogus INVOCATION message for non-registered registration ID");
+    }
+}
+
+inline void wamp_session::arm_admission_timer(const wamp_admission_control& admission)
+{
+    std::chrono::steady_clock::time_point deadline;
+    if (!admission.next_deadline(deadline)) {
+        return;
+    }
+
+    if (std::find(m_queued_admissions.begin(), m_queued_admissions.end(), admission) == m_queued_admissions.end()) {
+        m_queued_admissions.push_back(admission);
+    }
+
+    // Only a control queueing for the first time can bring the deadline forward.
+    if (m_admission_timer_armed && m_admission_deadline <= deadline) {
+        return;
+    }
+
+    // Moving an armed timer aborts the wait pending on it, which leaves the
+    // timer armed.
+    m_admission_timer_armed = true;
+    m_admission_deadline = deadline;
+    m_admission_timer.expires_at(deadline);
+
+    auto weak_self = std::weak_ptr<wamp_session>(this->shared_from_this());
+    m_admission_timer.async_wait(m_strand.wrap([weak_self](const boost::system::error_code& error) {
+        auto shared_self = weak_self.lock();
+        if (!shared_self) {
+            return;
+        }
+        shared_self->on_admission_timer(error);
+    }));
+}
+
+inline void wamp_session::on_admission_timer(const boost::system::error_code& error)
+{
+    if (error == boost::asio::error::operation_aborted) {
+        return;
+    }
+    m_admission_timer_armed = false;
+
+    // Controls with nothing left queued are dropped, and the timer is armed
+    // for the oldest invocation still queued on the others.
+    std::vector<wamp_admission_control> queued;
+    queued.swap(m_queued_admissions);
+    for (const auto& admission : queued) {
+        admission.reject_expired();
+    }
+    for (const auto& admission : queued) {
+        arm_admission_timer(admission);
+    }
+}
+
+inline void wamp_session::start_admitted_invocation(
+        uint64_t registration_id,
+        uint64_t request_id,
+        const wamp_invocation& invocation,
+        const std::shared_ptr<wamp_admission_slot>& slot)
+{
+    // Interrupted while queued, the dealer got wamp.error.canceled already.
+    if (!m_invocations.find(request_id)) {
+        return;
+    }
+
+    invocation->set_send_result_fn(invocation_reply_fn(request_id, slot));
+
+    const wamp_procedure* procedure = m_procedures.find(registration_id);
+    if (!procedure) {
+        invocation->error("wamp.error.no_such_registration");
+        return;
+    }
+
+    dispatch_guard guard(*this);
+    invoke_procedure(*procedure, invocation);
+}
+
+inline wamp_invocation_impl::send_result_fn wamp_session::invocation_reply_fn(
+        uint64_t request_id, const std::shared_ptr<wamp_admission_slot>& slot)
+{
+    auto weak_this = std::weak_ptr<wamp_session>(this->shared_from_this());
+
+    // The invocation drops this function with its final reply or when it is
+    // destroyed, releasing the admission slot, if any, either way.
+    return [weak_this, request_id, slot] (const std::shared_ptr<wamp_message>& message) {
+        // Make sure the session still exists, since the invocation could run
+        // on a different thread.
+        auto shared_this = weak_this.lock();
+        if (!shared_this) {
+            return; // FIXME: or throw exception?
+        }
+        shared_this->submit_invocation_reply(request_id, message);
+    };
+}
+
+inline void wamp_session::invoke_procedure(const wamp_procedure& procedure, const wamp_invocation& invocation)
+{
+    try {
+        procedure(invocation);
+    }
+
+    // FIXME: implement Autobahn-specific exception with error URI
+    catch (const std::exception& e) {
+        // we can at least describe the error with e.what()
+        //
+        if (invocation->sendable()) {
+            std::map<std::string, std::string> error_kw_arguments;
+            error_kw_arguments["what"] = e.what();
+            invocation->error("wamp.error.runtime_error", EMPTY_ARGUMENTS, error_kw_arguments);
+        }
+    }
+    catch (...) {
+        // no information available on actual error
+        //
+        if (invocation->sendable()) {
+            invocation->error("wamp.error.runtime_error");
+        }
+    }
+}
+
+inline wamp_procedure wamp_session::pooled_procedure(
+        const std::shared_ptr<wamp_invocation_executor>& pool, const wamp_procedure& procedure)
+{
+    // Only the registered procedure holds the pool, so the pool is never
+    // released by one of its own tasks.
+    return [pool, procedure](const wamp_invocation& invocation) {
+        pool->post(invocation, [procedure, invocation]() {
+            invoke_procedure(procedure, invocation);
+        });
+    };
+}
+
+inline void wamp_session::invoke_batch_procedure(
+        const wamp_batch_procedure& procedure, const std::vector<wamp_invocation>& invocations)
+{
+    // Invocations the procedure did not reply to before failing get the error.
+    try {
+        procedure(span<const wamp_invocation>(invocations.data(), invocations.size()));
+    } catch (const std::exception& e) {
+        std::map<std::string, std::string> error_kw_arguments;
+        error_kw_arguments["what"] = e.what();
+        for (const auto& invocation : invocations) {
             if (invocation->sendable()) {
-                std::map<std::string, std::string> error_kw_arguments;
-                error_kw_arguments["what"] = e.what();
                 invocation->error("wamp.error.runtime_error", EMPTY_ARGUMENTS, error_kw_arguments);
             }
         }
-        catch (...) {
-            // no information available on actual error
-            //
+    } catch (...) {
+        for (const auto& invocation : invocations) {
             if (invocation->sendable()) {
                 invocation->error("wamp.error.runtime_error");
             }
         }
-    } else {
-        throw protocol_error("bogus INVOCATION message for non-registered registration ID");
+    }
+}
+
+inline void wamp_session::process_interrupt(wamp_message&& message)
+{
+    // [INTERRUPT, INVOCATION.Request|id, Options|dict]
+
+    if (message.size() != 3) {
+        throw protocol_error("INTERRUPT message length must be 3");
+    }
+
+    if (!message.is_field_type(1, msgpack::type::POSITIVE_INTEGER)) {
+        throw protocol_error("INTERRUPT.Request must be an integer");
+    }
+    uint64_t request_id = message.field<uint64_t>(1);
+
+    if (!message.is_field_type(2, msgpack::type::MAP)) {
+        throw protocol_error("INTERRUPT.Options must be a map");
+    }
+    wamp_cancel_mode mode = cancel_mode_from_name(
+            value_for_key_or<std::string>(message.field(2), "mode", std::string()));
+
+    // The invocation may have been replied to already, with the INTERRUPT
+    // crossing the reply on the wire.
+    const std::weak_ptr<wamp_invocation_impl>* pending = m_invocations.find(request_id);
+    if (!pending) {
+        return;
+    }
+
+    // An invocation that is gone has its reply on the way to this thread.
+    wamp_invocation invocation = pending->lock();
+    if (!invocation) {
+        return;
+    }
+
+    // Replies the procedure sends from now on are dropped.
+    m_invocations.erase(request_id);
+    m_invocation_streams.erase(request_id);
+
+    if (m_debug_enabled) {
+        std::cerr << "Interrupting invocation " << request_id
+                << " (" << cancel_mode_name(mode) << ")" << std::endl;
+    }
+
+    invocation->interrupt(mode);
+
+    // With killnowait the dealer has answered the caller already and ignores the callee.
+    if (mode != wamp_cancel_mode::killnowait) {
+        // [ERROR, INVOCATION, INVOCATION.Request|id, Details|dict, Error|uri]
+        wamp_message error(5);
+        error.set_field(0, static_cast<int>(message_type::ERROR));
+        error.set_field(1, static_cast<int>(message_type::INVOCATION));
+        error.set_field(2, request_id);
+        error.set_field(3, std::map<int, int>() /* No details */);
+        error.set_field(4, std::string("wamp.error.canceled"));
+        send_message(std::move(error));
     }
 }
 
@@ -1159,12 +1817,13 @@ inline void wamp_session::process_call_result(wamp_message&& message)
     }
     uint64_t request_id = message.field<uint64_t>(1);
 
-    auto call_itr = m_calls.find(request_id);
-    if (call_itr != m_calls.end()) {
-        if (!message.is_field_type(2, msgpack::type::MAP)) {
-            throw protocol_error("RESULT - Details must be a dictionary");
-        }
+    if (!message.is_field_type(2, msgpack::type::MAP)) {
+        throw protocol_error("RESULT - Details must be a dictionary");
+    }
+    const bool progress = value_for_key_or<bool>(message.field(2), "progress", false);
 
+    wamp_call* pending = m_calls.find(request_id);
+    if (pending) {
         wamp_call_result result(std::move(message.zone()));
         if (message.size() > 3) {
             if (!message.is_field_type(3, msgpack::type::ARRAY)) {
@@ -1179,13 +1838,57 @@ inline void wamp_session::process_call_result(wamp_message&& message)
                 result.set_kw_arguments(message.field(4));
             }
         }
-        call_itr->second->set_result(std::move(result));
-        m_calls.erase(call_itr);
+
+        if (progress) {
+            // The call stays pending. The handler is held on to, since it may cancel the call.
+            std::shared_ptr<const wamp_progress_handler> progress_handler = pending->progress_handler();
+            if (progress_handler) {
+                try {
+                    (*progress_handler)(std::move(result));
+                } catch (...) {
+                    if (m_debug_enabled) {
+                        std::cerr << "Warning: progress handler threw exception" << std::endl;
+                    }
+                }
+            }
+            return;
+        }
+
+        take_call(request_id)->set_result(std::move(result));
+    } else if (m_canceled_calls.find(request_id)) {
+        // Further progressive results may follow until the final one.
+        if (!progress) {
+            forget_canceled_call(request_id);
+        }
     } else {
         throw protocol_error("bogus RESULT message for non-pending request ID");
     }
 }
 
+inline void wamp_session::process_published(wamp_message&& message)
+{
+    // [PUBLISHED, PUBLISH.Request|id, Publication|id]
+    if (message.size() != 3) {
+        throw protocol_error("PUBLISHED - length must be 3");
+    }
+
+    if (!message.is_field_type(1, msgpack::type::POSITIVE_INTEGER)) {
+        throw protocol_error("PUBLISHED - PUBLISH.Request must be an integer");
+    }
+    uint64_t request_id = message.field<uint64_t>(1);
+
+    auto publish_request = m_publish_requests.take(request_id);
+    if (publish_request) {
+        if (!message.is_field_type(2, msgpack::type::POSITIVE_INTEGER)) {
+            throw protocol_error("PUBLISHED - PUBLISHED.Publication must be an integer");
+        }
+        publish_request->set_response(wamp_publication(message.field<uint64_t>(2)));
+        release_publication_slots();
+    } else {
+        throw protocol_error("PUBLISHED - no pending request ID");
+    }
+}
+
 inline void wamp_session::process_subscribed(wamp_message&& message)
 {
     // [SUBSCRIBED, SUBSCRIBE.Request|id, Subscription|id]
@@ -1198,17 +1901,22 @@ inline void wamp_session::process_subscribed(wamp_message&& message)
     }
     uint64_t request_id = message.field<uint64_t>(1);
 
-    auto subscribe_request_itr = m_subscribe_requests.find(request_id);
-    if (subscribe_request_itr != m_subscribe_requests.end()) {
+    auto subscribe_request = m_subscribe_requests.take(request_id);
+    if (subscribe_request) {
         if (!message.is_field_type(2, msgpack::type::POSITIVE_INTEGER)) {
             throw protocol_error("SUBSCRIBED - SUBSCRIBED.Subscription must be an integer");
         }
 
         uint64_t subscription_id = message.field<uint64_t>(2);
-        m_subscription_handlers.insert(
-                std::make_pair(subscription_id, subscribe_request_itr->second->handler()));
-        subscribe_request_itr->second->set_response(wamp_subscription(subscription_id));
-        m_subscribe_requests.erase(request_id);
+        const wamp_event_handler& handler = subscribe_request->handler();
+        update_dispatch_tables([this, subscription_id, handler]() {
+            auto handlers = m_subscription_handlers.find(subscription_id);
+            if (!handlers) {
+                handlers = &m_subscription_handlers.emplace(subscription_id);
+            }
+            handlers->push_back(handler);
+        });
+        subscribe_request->set_response(wamp_subscription(subscription_id));
     } else {
         throw protocol_error("SUBSCRIBED - no pending request ID");
     }
@@ -1226,12 +1934,13 @@ inline void wamp_session::process_unsubscribed(wamp_message&& message)
     }
     uint64_t request_id = message.field<uint64_t>(1);
 
-    auto unsubscribe_request_itr = m_unsubscribe_requests.find(request_id);
-    if (unsubscribe_request_itr != m_unsubscribe_requests.end()) {
-        uint64_t subscription_id = unsubscribe_request_itr->second->subscription().id();
-        m_subscription_handlers.erase(subscription_id);
-        unsubscribe_request_itr->second->set_response();
-        m_unsubscribe_requests.erase(request_id);
+    auto unsubscribe_request = m_unsubscribe_requests.take(request_id);
+    if (unsubscribe_request) {
+        uint64_t subscription_id = unsubscribe_request->subscription().id();
+        update_dispatch_tables([this, subscription_id]() {
+            m_subscription_handlers.erase(subscription_id);
+        });
+        unsubscribe_request->set_response();
     } else {
         throw protocol_error("UNSUBSCRIBED - no pending request ID");
     }
@@ -1252,11 +1961,8 @@ inline void wamp_session::process_event(wamp_message&& message)
     }
     uint64_t subscription_id = message.field<uint64_t>(1);
 
-    auto subscription_handlers_itr = m_subscription_handlers.lower_bound(subscription_id);
-    auto subscription_handlers_end = m_subscription_handlers.upper_bound(subscription_id);
-
-    if (subscription_handlers_itr != m_subscription_handlers.end() &&
-            subscription_handlers_itr != subscription_handlers_end) {
+    const wamp_event_handlers* handlers = m_subscription_handlers.find(subscription_id);
+    if (handlers) {
 
         if (!message.is_field_type(2, msgpack::type::POSITIVE_INTEGER)) {
             throw protocol_error("EVENT - PUBLISHED.Publication must be an id");
@@ -1285,12 +1991,12 @@ inline void wamp_session::process_event(wamp_message&& message)
             }
         }
 
+        dispatch_guard guard(*this);
         try {
             // now trigger the user supplied event handler ..
             //
-            while (subscription_handlers_itr != subscription_handlers_end) {
-                 (subscription_handlers_itr->second)(event);
-                 ++subscription_handlers_itr;
+            for (const auto& handler : *handlers) {
+                handler(event);
             }
         } catch (...) {
             if (m_debug_enabled) {
@@ -1321,16 +2027,29 @@ inline void wamp_session::process_registered(wamp_message&& message)
     }
     uint64_t request_id = message.field<uint64_t>(1);
 
-    auto register_request_itr = m_register_requests.find(request_id);
-    if (register_request_itr != m_register_requests.end()) {
+    auto register_request = m_register_requests.take(request_id);
+    if (register_request) {
         if (!message.is_field_type(2, msgpack::type::POSITIVE_INTEGER)) {
             throw protocol_error("REGISTERED - REGISTERED.Registration must be an integer");
         }
         uint64_t registration_id = message.field<uint64_t>(2);
 
-        m_procedures[registration_id] = register_request_itr->second->procedure();
-        register_request_itr->second->set_response(wamp_registration(registration_id));
-        m_register_requests.erase(register_request_itr);
+        const wamp_procedure& procedure = register_request->procedure();
+        const wamp_admission_control& admission = register_request->admission();
+        update_dispatch_tables([this, registration_id, procedure, admission]() {
+            auto registered = m_procedures.find(registration_id);
+            if (registered) {
+                *registered = procedure;
+            } else {
+                m_procedures.emplace(registration_id, procedure);
+            }
+
+            m_admission_controls.erase(registration_id);
+            if (admission) {
+                m_admission_controls.emplace(registration_id, admission);
+            }
+        });
+        register_request->set_response(wamp_registration(registration_id));
     } else {
         throw protocol_error("REGISTERED - no pending request ID");
     }
@@ -1348,17 +2067,418 @@ inline void wamp_session::process_unregistered(wamp_message&& message)
     }
 
     uint64_t request_id = message.field<uint64_t>(1);
-	auto unregister_request_itr = m_unregister_requests.find(request_id);
-    if (unregister_request_itr != m_unregister_requests.end()) {
-        uint64_t registration_id = unregister_request_itr->second->registration().id();
-        m_procedures.erase(registration_id);
-        unregister_request_itr->second->set_response();
-        m_unregister_requests.erase(request_id);
+    auto unregister_request = m_unregister_requests.take(request_id);
+    if (unregister_request) {
+        uint64_t registration_id = unregister_request->registration().id();
+        update_dispatch_tables([this, registration_id]() {
+            m_procedures.erase(registration_id);
+            m_admission_controls.erase(registration_id);
+        });
+        unregister_request->set_response();
     } else {
         throw protocol_error("UNREGISTERED - no pending request ID");
     }
 }
 
+inline wamp_session::publish_initiation::publish_initiation(const std::shared_ptr<wamp_session>& session)
+    : m_session(session)
+{
+}
+
+template <typename Handler, typename Message>
+inline void wamp_session::publish_initiation::operator()(
+        Handler&& handler, uint64_t request_id, Message&& message, bool acknowledge) const
+{
+    auto session = m_session.lock();
+    if (!session) {
+        return;
+    }
+
+    publish_operation::completion_type completion(
+            std::forward<Handler>(handler), session->m_io_service.get_executor());
+    if (acknowledge) {
+        session->submit(
+                request_operation<wamp_publish_request>(
+                        m_session, &wamp_session::m_publish_requests, request_id,
+                        wamp_message(std::move(message)), wamp_publish_request(std::move(completion))));
+    } else {
+        session->submit(
+                publish_operation(m_session, wamp_message(std::move(message)), std::move(completion)));
+    }
+}
+
+template <typename Handler>
+inline void wamp_session::publish_initiation::operator()(
+        Handler&& handler, std::vector<wamp_message>&& messages) const
+{
+    auto session = m_session.lock();
+    if (!session) {
+        return;
+    }
+
+    publish_batch_operation::completion_type completion(
+            std::forward<Handler>(handler), session->m_io_service.get_executor());
+    session->submit(
+            publish_batch_operation(m_session, std::move(messages), std::move(completion)));
+}
+
+inline wamp_session::publish_operation::publish_operation(
+        const std::weak_ptr<wamp_session>& session,
+        wamp_message&& message,
+        completion_type&& completion)
+    : m_session(session)
+    , m_message(std::move(message))
+    , m_completion(std::move(completion))
+{
+}
+
+inline void wamp_session::publish_operation::operator()()
+{
+    auto session = m_session.lock();
+    if (!session) {
+        return;
+    }
+
+    try {
+        session->send_message(std::move(m_message));
+    } catch (...) {
+        m_completion.complete(std::current_exception());
+        return;
+    }
+    m_completion.complete(nullptr);
+}
+
+inline wamp_session::publish_batch_operation::publish_batch_operation(
+        const std::weak_ptr<wamp_session>& session,
+        std::vector<wamp_message>&& messages,
+        completion_type&& completion)
+    : m_session(session)
+    , m_messages(std::move(messages))
+    , m_completion(std::move(completion))
+{
+}
+
+inline void wamp_session::publish_batch_operation::operator()()
+{
+    auto session = m_session.lock();
+    if (!session) {
+        return;
+    }
+
+    try {
+        session->send_messages(std::move(m_messages));
+    } catch (...) {
+        m_completion.complete(std::current_exception());
+        return;
+    }
+    m_completion.complete(nullptr);
+}
+
+template <typename Record>
+inline wamp_session::request_initiation<Record>::request_initiation(
+        const std::shared_ptr<wamp_session>& session,
+        wamp_request_table<Record> wamp_session::* requests)
+    : m_session(session)
+    , m_requests(requests)
+{
+}
+
+template <typename Record>
+template <typename Handler, typename Message, typename... RecordArgs>
+inline void wamp_session::request_initiation<Record>::operator()(
+        Handler&& handler, uint64_t request_id, Message&& message, RecordArgs&&... record_args) const
+{
+    auto session = m_session.lock();
+    if (!session) {
+        return;
+    }
+
+    typename Record::completion_type completion(
+            std::forward<Handler>(handler), session->m_io_service.get_executor());
+    session->submit(
+            request_operation<Record>(m_session, m_requests, request_id, wamp_message(std::move(message)),
+                    Record(std::forward<RecordArgs>(record_args)..., std::move(completion))));
+}
+
+template <typename Record>
+inline wamp_session::request_operation<Record>::request_operation(
+        const std::weak_ptr<wamp_session>& session,
+        wamp_request_table<Record> wamp_session::* requests,
+        uint64_t request_id,
+        wamp_message&& message,
+        Record&& record)
+    : m_session(session)
+    , m_requests(requests)
+    , m_request_id(request_id)
+    , m_message(std::move(message))
+    , m_record(std::move(record))
+{
+}
+
+template <typename Record>
+inline void wamp_session::request_operation<Record>::operator()()
+{
+    auto session = m_session.lock();
+    if (!session) {
+        return;
+    }
+
+    try {
+        if (!session->admit_request(m_request_id, m_message, m_record)) {
+            return;
+        }
+        session->send_message(std::move(m_message));
+        Record& record = ((*session).*m_requests).emplace(m_request_id, std::move(m_record));
+        session->track_request(m_request_id, record);
+    } catch (...) {
+        m_record.set_exception(std::current_exception());
+    }
+}
+
+template <typename Record>
+inline bool wamp_session::admit_request(uint64_t /*request_id*/, wamp_message& /*message*/, Record& /*record*/)
+{
+    return true;
+}
+
+inline bool wamp_session::admit_request(uint64_t request_id, wamp_message& message, wamp_publish_request& request)
+{
+    if (m_publish_window == 0
+            || (m_queued_publications.empty() && m_publish_requests.size() < m_publish_window)) {
+        return true;
+    }
+
+    m_queued_publications.push_back(queued_publication{request_id, std::move(message), std::move(request)});
+    return false;
+}
+
+inline void wamp_session::release_publication_slots()
+{
+    while (!m_queued_publications.empty()
+            && (m_publish_window == 0 || m_publish_requests.size() < m_publish_window)) {
+        queued_publication publication = std::move(m_queued_publications.front());
+        m_queued_publications.pop_front();
+
+        try {
+            send_message(std::move(publication.message));
+            m_publish_requests.emplace(publication.request_id, std::move(publication.request));
+        } catch (...) {
+            publication.request.set_exception(std::current_exception());
+        }
+    }
+}
+
+inline std::unordered_map<std::string, bool> wamp_session::publish_options_map(
+        const wamp_publish_options& options, bool acknowledge)
+{
+    std::unordered_map<std::string, bool> options_map;
+    if (!options.exclude_me()) {
+        options_map["exclude_me"] = false;
+    }
+    if (acknowledge) {
+        options_map["acknowledge"] = true;
+    }
+
+    return options_map;
+}
+
+template <typename Record>
+inline void wamp_session::track_request(uint64_t /*request_id*/, Record& /*record*/)
+{
+}
+
+inline void wamp_session::track_request(uint64_t request_id, wamp_call& call)
+{
+    if (call.timeout().count() > 0) {
+        call.deadline() = m_call_deadlines.schedule(request_id, wamp_timer_wheel::clock::now() + call.timeout());
+        arm_call_timer();
+    }
+
+    // Binding may cancel the call right away, so the record is not used afterwards.
+    if (call.handle()) {
+        auto weak_self = std::weak_ptr<wamp_session>(this->shared_from_this());
+        call.handle().bind([weak_self, request_id](wamp_cancel_mode mode) {
+            auto shared_self = weak_self.lock();
+            if (!shared_self) {
+                return;
+            }
+
+            shared_self->submit([weak_self, request_id, mode]() {
+                auto shared_self = weak_self.lock();
+                if (!shared_self) {
+                    return;
+                }
+                shared_self->abandon_call(request_id, mode, std::make_exception_ptr(canceled_error()));
+            });
+        });
+    }
+}
+
+inline boost::optional<wamp_call> wamp_session::take_call(uint64_t request_id)
+{
+    auto call = m_calls.take(request_id);
+    if (call) {
+        m_call_deadlines.cancel(call->deadline());
+    }
+    return call;
+}
+
+inline bool wamp_session::forget_canceled_call(uint64_t request_id)
+{
+    auto linger = m_canceled_calls.take(request_id);
+    if (!linger) {
+        return false;
+    }
+    m_call_deadlines.cancel(*linger);
+    return true;
+}
+
+inline void wamp_session::abandon_call(uint64_t request_id, wamp_cancel_mode mode, std::exception_ptr exception)
+{
+    auto call = take_call(request_id);
+    if (!call) {
+        return;
+    }
+
+    // Whatever the dealer still sends for the call is ignored for a while. With
+    // no transport left nothing can arrive, so nothing is recorded.
+    if (m_transport) {
+        m_canceled_calls.emplace(request_id, m_call_deadlines.schedule(
+                request_id, wamp_timer_wheel::clock::now() + WAMP_CANCELED_CALL_LINGER));
+        arm_call_timer();
+    }
+
+    if (m_call_canceling) {
+        // [CANCEL, CALL.Request|id, Options|dict]
+        wamp_message message(3);
+        message.set_field(0, static_cast<int>(message_type::CANCEL));
+        message.set_field(1, request_id);
+        std::unordered_map<std::string, std::string> options;
+        options["mode"] = cancel_mode_name(mode);
+        message.set_field(2, options);
+
+        try {
+            send_message(std::move(message));
+        } catch (const std::exception& e) {
+            if (m_debug_enabled) {
+                std::cerr << "failed to send CANCEL: " << e.what() << std::endl;
+            }
+        }
+    }
+
+    call->set_exception(exception);
+}
+
+inline void wamp_session::arm_call_timer()
+{
+    if (m_call_timer_armed || m_call_deadlines.empty()) {
+        return;
+    }
+
+    m_call_timer_armed = true;
+    m_call_timer.expires_at(m_call_deadlines.next_tick());
+
+    auto weak_self = std::weak_ptr<wamp_session>(this->shared_from_this());
+    m_call_timer.async_wait(m_strand.wrap([weak_self](const boost::system::error_code& error) {
+        auto shared_self = weak_self.lock();
+        if (!shared_self) {
+            return;
+        }
+        shared_self->on_call_timer(error);
+    }));
+}
+
+inline void wamp_session::on_call_timer(const boost::system::error_code& error)
+{
+    m_call_timer_armed = false;
+    if (error == boost::asio::error::operation_aborted) {
+        return;
+    }
+
+    std::vector<uint64_t> expired;
+    m_call_deadlines.expire(wamp_timer_wheel::clock::now(), expired);
+    for (uint64_t request_id : expired) {
+        // The wheel holds the deadlines of pending calls and the end of the
+        // lingering of abandoned ones.
+        if (m_canceled_calls.erase(request_id)) {
+            continue;
+        }
+        abandon_call(request_id, wamp_cancel_mode::killnowait, std::make_exception_ptr(timeout_error()));
+    }
+
+    arm_call_timer();
+}
+
+inline void wamp_session::send_call_chunk(uint64_t request_id, wamp_message&& message)
+{
+    if (!m_calls.find(request_id)) {
+        return; // failed, canceled or timed out already
+    }
+
+    try {
+        send_message(std::move(message));
+    } catch (...) {
+        take_call(request_id)->set_exception(std::current_exception());
+    }
+}
+
+inline void wamp_session::send_invocation_reply(uint64_t request_id, wamp_message&& message)
+{
+    if (!m_invocations.find(request_id)) {
+        return; // interrupted, the dealer got wamp.error.canceled instead
+    }
+
+    // Anything but a progressive YIELD ends the invocation.
+    if (message.field<int>(0) != static_cast<int>(message_type::YIELD)
+            || !value_for_key_or<bool>(message.field(2), "progress", false)) {
+        m_invocations.erase(request_id);
+    }
+
+    send_message(std::move(message));
+}
+
+inline bool wamp_session::has_role_feature(
+        const msgpack::object& details, const char* role, const char* feature)
+{
+    try {
+        const msgpack::object roles = value_for_key_or(details, "roles", msgpack::object());
+        const msgpack::object role_details = value_for_key_or(roles, role, msgpack::object());
+        const msgpack::object features = value_for_key_or(role_details, "features", msgpack::object());
+        return value_for_key_or(features, feature, false);
+    } catch (const msgpack::type_error&) {
+        return false;
+    }
+}
+
+template <typename Update>
+inline void wamp_session::update_dispatch_tables(Update&& update)
+{
+    if (m_dispatch_depth == 0) {
+        update();
+    } else {
+        m_deferred_table_updates.emplace_back(std::forward<Update>(update));
+    }
+}
+
+inline wamp_session::dispatch_guard::dispatch_guard(wamp_session& session)
+    : m_session(session)
+{
+    ++m_session.m_dispatch_depth;
+}
+
+inline wamp_session::dispatch_guard::~dispatch_guard()
+{
+    if (--m_session.m_dispatch_depth > 0 || m_session.m_deferred_table_updates.empty()) {
+        return;
+    }
+
+    std::vector<std::function<void()>> updates;
+    updates.swap(m_session.m_deferred_table_updates);
+    for (auto& update : updates) {
+        update();
+    }
+}
+
 inline void wamp_session::send_message(wamp_message&& message, bool session_established)
 {
     if (!m_running) {
@@ -1377,9 +2497,285 @@ inline void wamp_session::send_message(wamp_message&& message, bool session_esta
         throw no_session_error();
     }
 
+    if (session_established && (m_cork_depth > 0 || m_send_coalescing.enabled())) {
+        queue_message(std::move(message));
+        return;
+    }
+
+    // Messages held back go first, e.g. before a GOODBYE.
+    flush_send_queue();
     m_transport->send_message(std::move(message));
 }
 
+inline void wamp_session::send_messages(std::vector<wamp_message>&& messages)
+{
+    if (messages.empty()) {
+        return;
+    }
+
+    if (!m_running) {
+        throw protocol_error("session not running");
+    }
+
+    if (!m_transport || !m_transport->is_connected()) {
+        throw no_transport_error();
+    }
+
+    if (!m_session_id) {
+        throw no_session_error();
+    }
+
+    flush_send_queue();
+    m_transport->send_messages(std::move(messages));
+}
+
+inline void wamp_session::queue_message(wamp_message&& message)
+{
+    m_send_queue_bytes += estimated_message_size(message);
+    m_send_queue.push_back(std::move(message));
+
+    const std::size_t max_messages = m_send_coalescing.max_messages();
+    const std::size_t max_bytes = m_send_coalescing.max_bytes();
+    if ((max_messages != 0 && m_send_queue.size() >= max_messages)
+            || (max_bytes != 0 && m_send_queue_bytes >= max_bytes)) {
+        flush_send_queue();
+        return;
+    }
+
+    if (m_cork_depth > 0 || m_flush_timer_armed) {
+        return;
+    }
+
+    m_flush_timer_armed = true;
+    m_flush_timer.expires_from_now(m_send_coalescing.max_delay());
+
+    auto weak_self = std::weak_ptr<wamp_session>(this->shared_from_this());
+    m_flush_timer.async_wait(m_strand.wrap([weak_self](const boost::system::error_code& error) {
+        auto shared_self = weak_self.lock();
+        if (!shared_self) {
+            return;
+        }
+        shared_self->on_flush_timer(error);
+    }));
+}
+
+inline void wamp_session::flush_send_queue()
+{
+    if (m_send_queue.empty()) {
+        return;
+    }
+
+    // The spare vector keeps its capacity, so that flushing does not allocate.
+    m_send_batch.swap(m_send_queue);
+    const std::size_t bytes = m_send_queue_bytes;
+    m_send_queue_bytes = 0;
+
+    {
+        std::lock_guard<std::mutex> lock(m_send_metrics_mutex);
+        m_send_metrics.record_flush(m_send_batch.size(), bytes);
+    }
+
+    try {
+        if (!m_transport || !m_transport->is_connected()) {
+            throw no_transport_error();
+        }
+        m_transport->send_messages(std::move(m_send_batch));
+    } catch (...) {
+        m_send_batch.clear();
+        throw;
+    }
+    m_send_batch.clear();
+}
+
+inline void wamp_session::on_flush_timer(const boost::system::error_code& error)
+{
+    if (error == boost::asio::error::operation_aborted) {
+        return;
+    }
+
+    m_flush_timer_armed = false;
+    if (m_cork_depth == 0) {
+        try_flush_send_queue();
+    }
+}
+
+template <typename Operation>
+inline void wamp_session::submit(Operation&& operation)
+{
+    if (m_strand.running_in_this_thread()) {
+        // Keep the order of operations submitted before from other threads.
+        drain_submissions();
+        operation();
+        return;
+    }
+
+    auto submission = make_submission(std::forward<Operation>(operation));
+    if (m_overflowing.load(std::memory_order_acquire) || !m_submissions.try_push(std::move(submission))) {
+        submit_overflow(std::move(submission));
+    }
+
+    schedule_drain();
+}
+
+inline void wamp_session::submit_invocation_reply(
+        uint64_t request_id, const std::shared_ptr<wamp_message>& message)
+{
+    if (m_strand.running_in_this_thread()) {
+        drain_submissions();
+        send_invocation_reply(request_id, std::move(*message));
+        return;
+    }
+
+    invocation_reply reply{request_id, message};
+    if (m_overflowing.load(std::memory_order_acquire) || !m_invocation_replies.try_push(std::move(reply))) {
+        submit_overflow(make_submission([this, request_id, message]() {
+            try {
+                send_invocation_reply(request_id, std::move(*message));
+            } catch (const std::exception& e) {
+                if (m_debug_enabled) {
+                    std::cerr << "failed to send invocation reply: " << e.what() << std::endl;
+                }
+            }
+        }));
+    }
+
+    schedule_drain();
+}
+
+inline void wamp_session::submit_overflow(std::unique_ptr<wamp_submission>&& submission)
+{
+    std::lock_guard<std::mutex> lock(m_overflow_mutex);
+    m_overflow.push_back(std::move(submission));
+    m_overflowing.store(true, std::memory_order_release);
+}
+
+inline void wamp_session::schedule_drain()
+{
+    if (!m_drain_scheduled.exchange(true)) {
+        auto weak_self = std::weak_ptr<wamp_session>(this->shared_from_this());
+        m_strand.post([weak_self]() {
+            auto shared_self = weak_self.lock();
+            if (shared_self) {
+                shared_self->drain_submissions();
+            }
+        });
+    }
+}
+
+inline void wamp_session::drain_submissions()
+{
+    do {
+        std::unique_ptr<wamp_submission> submission;
+        while (m_submissions.try_pop(submission)) {
+            submission->run();
+            submission.reset();
+        }
+        invocation_reply reply;
+        while (m_invocation_replies.try_pop(reply)) {
+            try {
+                send_invocation_reply(reply.request_id, std::move(*reply.message));
+            } catch (const std::exception& e) {
+                if (m_debug_enabled) {
+                    std::cerr << "failed to send invocation reply: " << e.what() << std::endl;
+                }
+            }
+            reply.message.reset();
+        }
+
+        // Submissions held back while the rings were full come after all that
+        // was in the rings before them.
+        if (m_overflowing.load(std::memory_order_acquire)) {
+            std::vector<std::unique_ptr<wamp_submission>> overflow;
+            {
+                std::lock_guard<std::mutex> lock(m_overflow_mutex);
+                overflow.swap(m_overflow);
+                m_overflowing.store(false, std::memory_order_release);
+            }
+            for (auto& held : overflow) {
+                held->run();
+                held.reset();
+            }
+        }
+        m_drain_scheduled.store(false);
+
+        // A producer may have pushed after the last pop but seen the drain
+        // still scheduled; pick its submission up rather than losing it.
+    } while ((m_submissions.ready() || m_invocation_replies.ready()
+                || m_overflowing.load(std::memory_order_acquire))
+            && !m_drain_scheduled.exchange(true));
+}
+
+inline void wamp_session::try_flush_send_queue()
+{
+    try {
+        flush_send_queue();
+    } catch (const std::exception& e) {
+        if (m_debug_enabled) {
+            std::cerr << "failed to flush outgoing messages: " << e.what() << std::endl;
+        }
+    }
+}
+
+inline void wamp_session::set_send_coalescing(const wamp_send_coalescing& coalescing)
+{
+    auto weak_self = std::weak_ptr<wamp_session>(this->shared_from_this());
+    submit([weak_self, coalescing]() {
+        auto shared_self = weak_self.lock();
+        if (!shared_self) {
+            return;
+        }
+
+        shared_self->m_send_coalescing = coalescing;
+        if (!coalescing.enabled() && shared_self->m_cork_depth == 0) {
+            shared_self->try_flush_send_queue();
+        }
+    });
+}
+
+inline void wamp_session::cork()
+{
+    // Submitted like the operations it applies to, so that it takes effect in order.
+    auto weak_self = std::weak_ptr<wamp_session>(this->shared_from_this());
+    submit([weak_self]() {
+        auto shared_self = weak_self.lock();
+        if (!shared_self) {
+            return;
+        }
+        ++shared_self->m_cork_depth;
+    });
+}
+
+inline void wamp_session::uncork()
+{
+    auto weak_self = std::weak_ptr<wamp_session>(this->shared_from_this());
+    submit([weak_self]() {
+        auto shared_self = weak_self.lock();
+        if (!shared_self || shared_self->m_cork_depth == 0) {
+            return;
+        }
+        if (--shared_self->m_cork_depth == 0) {
+            shared_self->try_flush_send_queue();
+        }
+    });
+}
+
+inline wamp_session::cork_scope::cork_scope(wamp_session& session)
+    : m_session(session)
+{
+    m_session.cork();
+}
+
+inline wamp_session::cork_scope::~cork_scope()
+{
+    m_session.uncork();
+}
+
+inline wamp_send_metrics wamp_session::send_metrics() const
+{
+    std::lock_guard<std::mutex> lock(m_send_metrics_mutex);
+    return m_send_metrics;
+}
+
 inline const std::unordered_map<std::string, msgpack::object>&  wamp_session::welcome_details()
 {
     return m_welcome_details;
@@ -0,0 +1,129 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Crossbar.io Technologies GmbH and contributors
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef AUTOBAHN_WAMP_SUBMISSION_QUEUE_HPP
+#define AUTOBAHN_WAMP_SUBMISSION_QUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+namespace autobahn {
+
+/*!
+ * An operation handed to the session's io_service thread through a
+ * wamp_submission_queue.
+ */
+class wamp_submission
+{
+public:
+    virtual ~wamp_submission() = default;
+    virtual void run() = 0;
+};
+
+template <typename Operation>
+class wamp_operation_submission : public wamp_submission
+{
+public:
+    explicit wamp_operation_submission(Operation&& operation);
+    virtual void run() override;
+
+private:
+    Operation m_operation;
+};
+
+template <typename Operation>
+std::unique_ptr<wamp_submission> make_submission(Operation&& operation);
+
+/*!
+ * Bounded lock-free queue with many producers and a single consumer, used by
+ * the session to take operations from application threads to its io_service
+ * thread without contending on the io_service's handler queue.
+ *
+ * Each slot carries a sequence number telling producers and the consumer whose
+ * turn it is, so producers only compete for the tail index with one atomic
+ * compare and exchange and never wait on each other while moving their values
+ * in. The consumer must be a single thread at a time.
+ */
+template <typename T>
+class wamp_submission_queue
+{
+public:
+    /*!
+     * Creates a queue for up to @p capacity values, rounded up to a power of two.
+     */
+    explicit wamp_submission_queue(std::size_t capacity);
+
+    wamp_submission_queue(const wamp_submission_queue&) = delete;
+    wamp_submission_queue& operator=(const wamp_submission_queue&) = delete;
+
+    /*!
+     * Appends @p value, which is left untouched if the queue is full.
+     *
+     * @return false if the queue is full.
+     */
+    bool try_push(T&& value);
+
+    /*!
+     * Removes the oldest value into @p value. Only called by the consumer.
+     *
+     * @return false if the queue is empty.
+     */
+    bool try_pop(T& value);
+
+    /*!
+     * Whether a value is ready to be popped. Only called by the consumer.
+     */
+    bool ready() const;
+
+private:
+    struct slot
+    {
+        std::atomic<std::size_t> sequence;
+        T value;
+    };
+
+    // Keeps the producers' and the consumer's index on separate cache lines.
+    static const std::size_t CACHE_LINE_SIZE = 64;
+
+    std::unique_ptr<slot[]> m_slots;
+    std::size_t m_mask;
+    char m_padding0[CACHE_LINE_SIZE];
+    std::atomic<std::size_t> m_tail;
+    char m_padding1[CACHE_LINE_SIZE];
+    std::size_t m_head;
+};
+
+} // namespace autobahn
+
+#include "wamp_submission_queue.ipp"
+
+#endif // AUTOBAHN_WAMP_SUBMISSION_QUEUE_HPP
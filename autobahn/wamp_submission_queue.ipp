@@ -0,0 +1,124 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Crossbar.io Technologies GmbH and contributors
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include <type_traits>
+#include <utility>
+
+namespace autobahn {
+
+template <typename Operation>
+inline wamp_operation_submission<Operation>::wamp_operation_submission(Operation&& operation)
+    : m_operation(std::move(operation))
+{
+}
+
+template <typename Operation>
+inline void wamp_operation_submission<Operation>::run()
+{
+    m_operation();
+}
+
+template <typename Operation>
+inline std::unique_ptr<wamp_submission> make_submission(Operation&& operation)
+{
+    using operation_type = typename std::decay<Operation>::type;
+    return std::unique_ptr<wamp_submission>(
+            new wamp_operation_submission<operation_type>(std::forward<Operation>(operation)));
+}
+
+template <typename T>
+inline wamp_submission_queue<T>::wamp_submission_queue(std::size_t capacity)
+    : m_slots()
+    , m_mask(0)
+    , m_tail(0)
+    , m_head(0)
+{
+    std::size_t size = 2;
+    while (size < capacity) {
+        size *= 2;
+    }
+
+    m_slots.reset(new slot[size]);
+    m_mask = size - 1;
+    for (std::size_t i = 0; i < size; ++i) {
+        m_slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+template <typename T>
+inline bool wamp_submission_queue<T>::try_push(T&& value)
+{
+    std::size_t position = m_tail.load(std::memory_order_relaxed);
+    for (;;) {
+        slot& candidate = m_slots[position & m_mask];
+        const std::size_t sequence = candidate.sequence.load(std::memory_order_acquire);
+        const std::ptrdiff_t difference =
+                static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+
+        if (difference == 0) {
+            // The slot is free for this position, claim it.
+            if (m_tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                candidate.value = std::move(value);
+                candidate.sequence.store(position + 1, std::memory_order_release);
+                return true;
+            }
+        } else if (difference < 0) {
+            // The slot still holds the value from one lap ago.
+            return false;
+        } else {
+            position = m_tail.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+template <typename T>
+inline bool wamp_submission_queue<T>::try_pop(T& value)
+{
+    if (!ready()) {
+        return false;
+    }
+
+    slot& oldest = m_slots[m_head & m_mask];
+    value = std::move(oldest.value);
+    oldest.sequence.store(m_head + m_mask + 1, std::memory_order_release);
+    ++m_head;
+
+    return true;
+}
+
+template <typename T>
+inline bool wamp_submission_queue<T>::ready() const
+{
+    const slot& oldest = m_slots[m_head & m_mask];
+    return oldest.sequence.load(std::memory_order_acquire) == m_head + 1;
+}
+
+} // namespace autobahn
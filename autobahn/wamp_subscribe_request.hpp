@@ -31,9 +31,11 @@
 #ifndef AUTOBAHN_WAMP_SUBSCRIBE_REQUEST_HPP
 #define AUTOBAHN_WAMP_SUBSCRIBE_REQUEST_HPP
 
+#include "wamp_completion.hpp"
 #include "wamp_event_handler.hpp"
 #include "wamp_subscription.hpp"
-#include "boost_config.hpp"
+
+#include <exception>
 
 namespace autobahn {
 
@@ -41,17 +43,18 @@ namespace autobahn {
 class wamp_subscribe_request
 {
 public:
+    using completion_type = wamp_completion<void(std::exception_ptr, wamp_subscription)>;
+
     wamp_subscribe_request();
-    wamp_subscribe_request(const wamp_event_handler& handler);
+    wamp_subscribe_request(const wamp_event_handler& handler, completion_type&& completion);
 
     const wamp_event_handler& handler() const;
-    boost::promise<wamp_subscription>& response();
-    void set_handler(const wamp_event_handler& handler) const;
     void set_response(const wamp_subscription& subscription);
+    void set_exception(std::exception_ptr exception);
 
 private:
     wamp_event_handler m_handler;
-    boost::promise<wamp_subscription> m_response;
+    completion_type m_completion;
 };
 
 } // namespace autobahn
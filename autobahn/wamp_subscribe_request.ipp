@@ -32,13 +32,14 @@ namespace autobahn {
 
 inline wamp_subscribe_request::wamp_subscribe_request()
     : m_handler()
-    , m_response()
+    , m_completion()
 {
 }
 
-inline wamp_subscribe_request::wamp_subscribe_request(const wamp_event_handler& handler)
+inline wamp_subscribe_request::wamp_subscribe_request(
+        const wamp_event_handler& handler, completion_type&& completion)
     : m_handler(handler)
-    , m_response()
+    , m_completion(std::move(completion))
 {
 }
 
@@ -47,14 +48,14 @@ inline const wamp_event_handler& wamp_subscribe_request::handler() const
     return m_handler;
 }
 
-inline boost::promise<wamp_subscription>& wamp_subscribe_request::response()
+inline void wamp_subscribe_request::set_response(const wamp_subscription& subscription)
 {
-    return m_response;
+    m_completion.complete(nullptr, subscription);
 }
 
-inline void wamp_subscribe_request::set_response(const wamp_subscription& subscription)
+inline void wamp_subscribe_request::set_exception(std::exception_ptr exception)
 {
-    m_response.set_value(subscription);
+    m_completion.fail(std::move(exception));
 }
 
 } // namespace autobahn
@@ -0,0 +1,141 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Crossbar.io Technologies GmbH and contributors
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef AUTOBAHN_WAMP_TIMER_WHEEL_HPP
+#define AUTOBAHN_WAMP_TIMER_WHEEL_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace autobahn {
+
+/*!
+ * Hashed timer wheel tracking deadlines of WAMP requests by request id.
+ *
+ * Deadlines are rounded up to ticks of a fixed resolution and hashed into a
+ * ring of slots by tick, so scheduling is O(1) and each tick only looks at the
+ * entries of one slot. Entries whose deadline is more than one revolution away
+ * stay in their slot until their tick comes around.
+ *
+ * Entries are linked into their slot and recycled through a free list, so the
+ * owner cancels the deadline of a request that completes in O(1) through the
+ * handle schedule() returned, and the wheel only holds requests in flight. The
+ * wheel is driven by a single timer of its owner and is not thread safe.
+ */
+class wamp_timer_wheel
+{
+public:
+    using clock = std::chrono::steady_clock;
+
+    /*!
+     * Refers to a scheduled deadline. Stays safe to cancel after the deadline
+     * expired or its entry was reused.
+     */
+    class handle
+    {
+    public:
+        handle();
+
+        /// Whether the handle refers to a deadline that was scheduled.
+        explicit operator bool() const;
+
+    private:
+        friend class wamp_timer_wheel;
+
+        handle(uint32_t index, uint32_t generation);
+
+        uint32_t m_index;
+        uint32_t m_generation;
+    };
+
+    wamp_timer_wheel(
+            const std::chrono::milliseconds& resolution = std::chrono::milliseconds(10),
+            std::size_t num_slots = 512);
+
+    /*!
+     * Adds a deadline for the given id.
+     */
+    handle schedule(uint64_t id, const clock::time_point& deadline);
+
+    /*!
+     * Removes the deadline @p timer refers to, unless it has expired already,
+     * and resets @p timer.
+     */
+    void cancel(handle& timer);
+
+    /*!
+     * Advances the wheel to the given time, appending the ids whose deadline
+     * has passed to @p expired.
+     */
+    void expire(const clock::time_point& now, std::vector<uint64_t>& expired);
+
+    /*!
+     * The time at which the next tick is due.
+     */
+    clock::time_point next_tick() const;
+
+    std::size_t size() const;
+    bool empty() const;
+
+private:
+    static const uint32_t NO_ENTRY = 0xffffffff;
+
+    struct entry
+    {
+        uint64_t id;
+        uint64_t tick;
+        uint32_t prev;
+        uint32_t next;
+
+        // Bumped whenever the entry is released, which invalidates its handles.
+        uint32_t generation;
+    };
+
+    uint64_t tick_at(const clock::time_point& time, bool round_up) const;
+    void unlink(uint32_t index);
+    void release(uint32_t index);
+
+    const clock::duration m_resolution;
+    const clock::time_point m_origin;
+    std::vector<entry> m_entries;
+    std::vector<uint32_t> m_slots;
+    uint32_t m_free;
+    uint64_t m_current_tick;
+    std::size_t m_size;
+};
+
+} // namespace autobahn
+
+#include "wamp_timer_wheel.ipp"
+
+#endif // AUTOBAHN_WAMP_TIMER_WHEEL_HPP
@@ -0,0 +1,181 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Crossbar.io Technologies GmbH and contributors
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include <algorithm>
+
+namespace autobahn {
+
+inline wamp_timer_wheel::handle::handle()
+    : m_index(NO_ENTRY)
+    , m_generation(0)
+{
+}
+
+inline wamp_timer_wheel::handle::handle(uint32_t index, uint32_t generation)
+    : m_index(index)
+    , m_generation(generation)
+{
+}
+
+inline wamp_timer_wheel::handle::operator bool() const
+{
+    return m_index != NO_ENTRY;
+}
+
+inline wamp_timer_wheel::wamp_timer_wheel(
+        const std::chrono::milliseconds& resolution, std::size_t num_slots)
+    : m_resolution(std::max<clock::duration>(resolution, clock::duration(1)))
+    , m_origin(clock::now())
+    , m_entries()
+    , m_slots(std::max<std::size_t>(num_slots, 1), uint32_t(NO_ENTRY))
+    , m_free(NO_ENTRY)
+    , m_current_tick(0)
+    , m_size(0)
+{
+}
+
+inline wamp_timer_wheel::handle wamp_timer_wheel::schedule(uint64_t id, const clock::time_point& deadline)
+{
+    // Never schedule into a tick that has already been processed.
+    const uint64_t tick = std::max(tick_at(deadline, true), m_current_tick + 1);
+
+    uint32_t index = m_free;
+    if (index != NO_ENTRY) {
+        m_free = m_entries[index].next;
+    } else {
+        index = static_cast<uint32_t>(m_entries.size());
+        m_entries.push_back(entry{0, 0, NO_ENTRY, NO_ENTRY, 0});
+    }
+
+    uint32_t& head = m_slots[tick % m_slots.size()];
+    entry& scheduled = m_entries[index];
+    scheduled.id = id;
+    scheduled.tick = tick;
+    scheduled.prev = NO_ENTRY;
+    scheduled.next = head;
+    if (head != NO_ENTRY) {
+        m_entries[head].prev = index;
+    }
+    head = index;
+    ++m_size;
+
+    return handle(index, scheduled.generation);
+}
+
+inline void wamp_timer_wheel::cancel(handle& timer)
+{
+    if (timer && timer.m_index < m_entries.size()
+            && m_entries[timer.m_index].generation == timer.m_generation) {
+        unlink(timer.m_index);
+        release(timer.m_index);
+    }
+    timer = handle();
+}
+
+inline void wamp_timer_wheel::expire(const clock::time_point& now, std::vector<uint64_t>& expired)
+{
+    const uint64_t target_tick = tick_at(now, false);
+    if (target_tick <= m_current_tick) {
+        return;
+    }
+
+    // After a full revolution every slot has been visited, so a late wakeup
+    // costs at most one pass over the wheel.
+    const uint64_t steps = std::min<uint64_t>(target_tick - m_current_tick, m_slots.size());
+    for (uint64_t step = 1; step <= steps && m_size > 0; ++step) {
+        uint32_t index = m_slots[(m_current_tick + step) % m_slots.size()];
+        while (index != NO_ENTRY) {
+            const uint32_t next = m_entries[index].next;
+            if (m_entries[index].tick <= target_tick) {
+                expired.push_back(m_entries[index].id);
+                unlink(index);
+                release(index);
+            }
+            index = next;
+        }
+    }
+
+    m_current_tick = target_tick;
+}
+
+inline wamp_timer_wheel::clock::time_point wamp_timer_wheel::next_tick() const
+{
+    return m_origin + m_resolution * static_cast<clock::rep>(m_current_tick + 1);
+}
+
+inline std::size_t wamp_timer_wheel::size() const
+{
+    return m_size;
+}
+
+inline bool wamp_timer_wheel::empty() const
+{
+    return m_size == 0;
+}
+
+inline uint64_t wamp_timer_wheel::tick_at(const clock::time_point& time, bool round_up) const
+{
+    if (time <= m_origin) {
+        return 0;
+    }
+
+    const clock::duration elapsed = time - m_origin;
+    uint64_t tick = static_cast<uint64_t>(elapsed / m_resolution);
+    if (round_up && elapsed % m_resolution != clock::duration::zero()) {
+        ++tick;
+    }
+
+    return tick;
+}
+
+inline void wamp_timer_wheel::unlink(uint32_t index)
+{
+    const entry& unlinked = m_entries[index];
+    if (unlinked.prev != NO_ENTRY) {
+        m_entries[unlinked.prev].next = unlinked.next;
+    } else {
+        m_slots[unlinked.tick % m_slots.size()] = unlinked.next;
+    }
+    if (unlinked.next != NO_ENTRY) {
+        m_entries[unlinked.next].prev = unlinked.prev;
+    }
+    --m_size;
+}
+
+inline void wamp_timer_wheel::release(uint32_t index)
+{
+    entry& released = m_entries[index];
+    ++released.generation;
+    released.next = m_free;
+    m_free = index;
+}
+
+} // namespace autobahn
@@ -32,13 +32,14 @@
 #define AUTOBAHN_WAMP_TRANSPORT_HPP
 
 #include "boost_config.hpp"
+#include "wamp_message.hpp"
 
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace autobahn {
 
-class wamp_message;
 class wamp_transport_handler;
 
 /*!
@@ -101,6 +102,21 @@ public:
      */
     virtual void send_message(wamp_message&& message) = 0;
 
+    /*!
+     * Send a batch of messages synchronously over the transport, in order.
+     *
+     * Transports that can serialize the batch into a single write should
+     * override this. The default sends the messages one by one.
+     *
+     * @param messages The messages to be sent.
+     */
+    virtual void send_messages(std::vector<wamp_message>&& messages)
+    {
+        for (auto& message : messages) {
+            send_message(std::move(message));
+        }
+    }
+
     /*!
      * Set the handler to be invoked when the transport detects congestion
      * sending to the remote peer and needs to apply backpressure on the
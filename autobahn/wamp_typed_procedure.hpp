@@ -0,0 +1,197 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Crossbar.io Technologies GmbH and contributors
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef AUTOBAHN_WAMP_TYPED_PROCEDURE_HPP
+#define AUTOBAHN_WAMP_TYPED_PROCEDURE_HPP
+
+#include "wamp_arguments.hpp"
+#include "wamp_call_result.hpp"
+#include "wamp_invocation.hpp"
+#include "wamp_procedure.hpp"
+#include "boost_config.hpp"
+
+#include <boost/optional.hpp>
+#include <msgpack.hpp>
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace autobahn {
+
+/*!
+ * Describes a remote procedure by its C++ signature, e.g. wamp_signature<int(int, int)>.
+ * Used by wamp_session::typed_call() and the typed wamp_session::provide().
+ */
+template <typename Signature>
+struct wamp_signature;
+
+template <typename R, typename... Args>
+struct wamp_signature<R(Args...)>
+{
+    using result_type = R;
+    using arguments_type = std::tuple<typename std::decay<Args>::type...>;
+    using indices_type = typename make_argument_indices<sizeof...(Args)>::type;
+
+    static constexpr std::size_t arity = sizeof...(Args);
+};
+
+/*!
+ * Whether a Function can implement a procedure of the given signature: it is
+ * callable with the decoded parameters and its result converts to the result
+ * type of the signature, which a void signature does not look at.
+ */
+template <typename Function, typename Signature>
+struct wamp_implements_signature;
+
+template <typename Function, typename R, typename... Args>
+struct wamp_implements_signature<Function, R(Args...)>
+{
+private:
+    template <typename F>
+    static auto result(int) -> decltype(std::declval<F&>()(std::declval<typename std::decay<Args>::type>()...));
+
+    template <typename F>
+    static void result(...);
+
+    template <typename F>
+    static auto callable(int) -> decltype(
+            (void)std::declval<F&>()(std::declval<typename std::decay<Args>::type>()...), std::true_type());
+
+    template <typename F>
+    static std::false_type callable(...);
+
+public:
+    static constexpr bool value = decltype(callable<Function>(0))::value
+            && (std::is_void<R>::value || std::is_convertible<decltype(result<Function>(0)), R>::value);
+};
+
+/// Result of wamp_session::typed_call(), which only participates for matching arities.
+template <typename Signature, std::size_t Arity>
+using typed_call_future = typename std::enable_if<
+        Arity == wamp_signature<Signature>::arity,
+        boost::future<typename wamp_signature<Signature>::result_type>>::type;
+
+template <typename Tuple, std::size_t... Indices>
+inline Tuple decode_arguments(const msgpack::object* items, argument_indices<Indices...>)
+{
+    return Tuple(argument_as<typename std::tuple_element<Indices, Tuple>::type>(items[Indices])...);
+}
+
+/*!
+ * Decodes the positional arguments of a call into the parameter types of Signature.
+ * The arity is checked once, after which each element is converted directly into
+ * its parameter type.
+ *
+ * @throw msgpack::type_error
+ */
+template <typename Signature>
+inline typename wamp_signature<Signature>::arguments_type decode_arguments(const msgpack::object& arguments)
+{
+    using signature = wamp_signature<Signature>;
+
+    if (arguments.type != msgpack::type::ARRAY || arguments.via.array.size != signature::arity) {
+        throw msgpack::type_error();
+    }
+
+    return decode_arguments<typename signature::arguments_type>(
+            arguments.via.array.ptr, typename signature::indices_type());
+}
+
+template <typename R>
+struct typed_result
+{
+    template <typename Function, typename Tuple, std::size_t... Indices>
+    static void invoke(
+            Function& function, Tuple& arguments,
+            const wamp_invocation& invocation, argument_indices<Indices...>)
+    {
+        invocation->result(std::make_tuple(function(std::get<Indices>(std::move(arguments))...)));
+    }
+
+    static R decode(const wamp_call_result& result)
+    {
+        return result.argument<R>(0);
+    }
+};
+
+template <>
+struct typed_result<void>
+{
+    template <typename Function, typename Tuple, std::size_t... Indices>
+    static void invoke(
+            Function& function, Tuple& arguments,
+            const wamp_invocation& invocation, argument_indices<Indices...>)
+    {
+        function(std::get<Indices>(std::move(arguments))...);
+        invocation->empty_result();
+    }
+
+    static void decode(const wamp_call_result&)
+    {
+    }
+};
+
+/*!
+ * Adapts a function with the given signature to a wamp_procedure. Invocations whose
+ * arguments do not match the signature are answered with wamp.error.invalid_argument.
+ */
+template <typename Signature, typename Function>
+inline wamp_procedure make_typed_procedure(Function&& function)
+{
+    using signature = wamp_signature<Signature>;
+    using function_type = typename std::decay<Function>::type;
+
+    static_assert(wamp_implements_signature<function_type, Signature>::value,
+            "the function does not take the parameters or return the result of the signature");
+
+    auto shared_function = std::make_shared<function_type>(std::forward<Function>(function));
+    return [shared_function](wamp_invocation invocation) {
+        msgpack::object raw_arguments;
+        invocation->get_arguments(raw_arguments);
+
+        boost::optional<typename signature::arguments_type> arguments;
+        try {
+            arguments = decode_arguments<Signature>(raw_arguments);
+        } catch (const msgpack::type_error&) {
+            invocation->error("wamp.error.invalid_argument");
+            return;
+        }
+
+        typed_result<typename signature::result_type>::invoke(
+                *shared_function, *arguments, invocation, typename signature::indices_type());
+    };
+}
+
+} // namespace autobahn
+
+#endif // AUTOBAHN_WAMP_TYPED_PROCEDURE_HPP
@@ -0,0 +1,133 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Crossbar.io Technologies GmbH and contributors
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "benchmark.hpp"
+
+#include <autobahn/wamp_event.hpp>
+#include <autobahn/wamp_event_handler.hpp>
+#include <autobahn/wamp_invocation.hpp>
+#include <autobahn/wamp_procedure.hpp>
+#include <autobahn/wamp_request_table.hpp>
+#include <cstdint>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+// Compares dispatching events and invocations through the tree maps the
+// session used to keep, with the wamp_request_table it keeps now, for 1, 10k
+// and 100k subscriptions and registrations. Ids are random, as routers hand
+// them out, and so is the order of the messages dispatched.
+
+namespace {
+
+const std::size_t MESSAGES = 1000000;
+
+void compare(std::size_t count)
+{
+    std::mt19937_64 random(count);
+    std::uniform_int_distribution<uint64_t> any_id(1, uint64_t(1) << 53);
+    std::vector<uint64_t> ids(count);
+    for (auto& id : ids) {
+        id = any_id(random);
+    }
+
+    std::uniform_int_distribution<std::size_t> any_index(0, count - 1);
+    std::vector<uint64_t> messages(MESSAGES);
+    for (auto& id : messages) {
+        id = ids[any_index(random)];
+    }
+
+    uint64_t dispatched = 0;
+    const autobahn::wamp_event event;
+    const autobahn::wamp_event_handler handler = [&dispatched](const autobahn::wamp_event&) { ++dispatched; };
+    const autobahn::wamp_invocation invocation;
+    const autobahn::wamp_procedure procedure = [&dispatched](autobahn::wamp_invocation) { ++dispatched; };
+    const std::string label = std::to_string(count) + " ";
+
+    std::multimap<uint64_t, autobahn::wamp_event_handler> handler_map;
+    autobahn::wamp_request_table<autobahn::wamp_event_handlers> handler_table;
+    std::map<uint64_t, autobahn::wamp_procedure> procedure_map;
+    autobahn::wamp_request_table<autobahn::wamp_procedure> procedure_table;
+    for (uint64_t id : ids) {
+        handler_map.emplace(id, handler);
+        handler_table.emplace(id).push_back(handler);
+        procedure_map.emplace(id, procedure);
+        procedure_table.emplace(id, procedure);
+    }
+
+    measure(label + "subscriptions std::multimap", MESSAGES, [&]() {
+        for (uint64_t id : messages) {
+            auto last = handler_map.upper_bound(id);
+            for (auto entry = handler_map.lower_bound(id); entry != last; ++entry) {
+                entry->second(event);
+            }
+        }
+    });
+
+    measure(label + "subscriptions wamp_request_table", MESSAGES, [&]() {
+        for (uint64_t id : messages) {
+            if (autobahn::wamp_event_handlers* handlers = handler_table.find(id)) {
+                for (const auto& subscriber : *handlers) {
+                    subscriber(event);
+                }
+            }
+        }
+    });
+
+    measure(label + "registrations std::map", MESSAGES, [&]() {
+        for (uint64_t id : messages) {
+            auto entry = procedure_map.find(id);
+            if (entry != procedure_map.end()) {
+                entry->second(invocation);
+            }
+        }
+    });
+
+    measure(label + "registrations wamp_request_table", MESSAGES, [&]() {
+        for (uint64_t id : messages) {
+            if (autobahn::wamp_procedure* registered = procedure_table.find(id)) {
+                (*registered)(invocation);
+            }
+        }
+    });
+
+    benchmark_sink = dispatched;
+}
+
+} // namespace
+
+int main()
+{
+    for (std::size_t count : {1, 10000, 100000}) {
+        compare(count);
+    }
+    return 0;
+}
@@ -0,0 +1,87 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Crossbar.io Technologies GmbH and contributors
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "benchmark.hpp"
+
+#include <autobahn/wamp_arguments.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Compares decoding numeric array arguments through msgpack's per-element
+// conversion with autobahn::decode_numeric_array(), which the argument
+// accessors use for vectors of numbers.
+
+namespace {
+
+// Elements decoded per measurement, whatever the array size.
+const std::size_t ELEMENTS = std::size_t(1) << 24;
+
+template <typename T>
+void compare(const std::string& type, std::size_t size)
+{
+    std::vector<T> sent(size);
+    for (std::size_t i = 0; i < size; ++i) {
+        sent[i] = static_cast<T>(i * 3 + 1);
+    }
+
+    // Arrays are unpacked into msgpack objects like these.
+    msgpack::zone zone;
+    const msgpack::object array(sent, zone);
+    const std::size_t rounds = ELEMENTS / size;
+    const std::string label = type + "[" + std::to_string(size) + "] ";
+
+    measure(label + "msgpack conversion", rounds * size, [&]() {
+        for (std::size_t round = 0; round < rounds; ++round) {
+            std::vector<T> values = array.as<std::vector<T>>();
+            benchmark_sink = values[round % size];
+        }
+    });
+
+    measure(label + "decode_numeric_array", rounds * size, [&]() {
+        std::vector<T> values;
+        for (std::size_t round = 0; round < rounds; ++round) {
+            autobahn::decode_numeric_array(array, values);
+            benchmark_sink = values[round % size];
+        }
+    });
+}
+
+} // namespace
+
+int main()
+{
+    for (std::size_t size : {16, 1024, 65536}) {
+        compare<double>("double", size);
+        compare<float>("float", size);
+        compare<int32_t>("int32", size);
+    }
+    return 0;
+}
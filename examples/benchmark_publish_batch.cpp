@@ -0,0 +1,111 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Crossbar.io Technologies GmbH and contributors
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "benchmark.hpp"
+#include "loopback_router.hpp"
+
+#include <autobahn/autobahn.hpp>
+#include <boost/asio.hpp>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+// Compares publishing small events one by one with publishing them in
+// batches through wamp_session::publish_batch(), on a session attached to a
+// loopback router. The router has no subscribers, so what is measured is
+// the cost of the session and the transport hand-over per event.
+
+namespace {
+
+const std::size_t EVENTS = 200000;
+
+} // namespace
+
+int main()
+{
+    boost::asio::io_service io;
+    std::unique_ptr<boost::asio::io_service::work> work(new boost::asio::io_service::work(io));
+    std::thread io_thread([&io]() { io.run(); });
+
+    auto router = std::make_shared<loopback_router>(io);
+    auto session = std::make_shared<autobahn::wamp_session>(io);
+    router->attach(std::static_pointer_cast<autobahn::wamp_transport_handler>(session));
+
+    bool stopped = false;
+    try {
+        router->connect().get();
+        session->start().get();
+        session->join("realm1").get();
+
+        measure("publish", EVENTS, [&]() {
+            std::vector<boost::future<void>> publications;
+            publications.reserve(EVENTS);
+            for (std::size_t i = 0; i < EVENTS; ++i) {
+                publications.push_back(session->publish("com.examples.ticks", std::make_tuple(uint64_t(i))));
+            }
+            for (auto& publication : publications) {
+                publication.get();
+            }
+        });
+
+        for (std::size_t batch_size : {10, 100, 1000}) {
+            measure("publish_batch of " + std::to_string(batch_size), EVENTS, [&]() {
+                std::vector<boost::future<void>> batches;
+                std::vector<std::tuple<uint64_t>> events(batch_size);
+                for (std::size_t i = 0; i < EVENTS; i += batch_size) {
+                    for (std::size_t j = 0; j < batch_size; ++j) {
+                        std::get<0>(events[j]) = i + j;
+                    }
+                    batches.push_back(session->publish_batch("com.examples.ticks", events));
+                }
+                for (auto& batch : batches) {
+                    batch.get();
+                }
+            });
+        }
+
+        session->leave().get();
+        session->stop().get();
+        router->detach();
+        stopped = true;
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        io.stop();
+    }
+
+    // The io thread is joined however the run ended.
+    work.reset();
+    io_thread.join();
+    return stopped ? 0 : 1;
+}
@@ -0,0 +1,90 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Crossbar.io Technologies GmbH and contributors
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "benchmark.hpp"
+
+#include <autobahn/wamp_call.hpp>
+#include <autobahn/wamp_request_table.hpp>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+
+// Compares tracking pending calls in a std::map of shared records, as the
+// session used to, with autobahn::wamp_request_table. Calls are made and
+// completed in a rolling window of outstanding calls with sequential
+// request ids, which is how the session hands them out.
+
+namespace {
+
+const std::size_t CALLS = 1000000;
+
+void compare(std::size_t outstanding)
+{
+    const std::string label = std::to_string(outstanding) + " outstanding ";
+
+    measure(label + "std::map<shared_ptr>", CALLS, [&]() {
+        std::map<uint64_t, std::shared_ptr<autobahn::wamp_call>> calls;
+        uint64_t request_id = 0;
+        for (std::size_t i = 0; i < outstanding; ++i) {
+            calls[++request_id] = std::make_shared<autobahn::wamp_call>();
+        }
+        for (std::size_t i = 0; i < CALLS; ++i) {
+            auto completed = calls.find(request_id - outstanding + 1);
+            std::shared_ptr<autobahn::wamp_call> call = std::move(completed->second);
+            calls.erase(completed);
+            calls[++request_id] = std::make_shared<autobahn::wamp_call>();
+        }
+        benchmark_sink = calls.size();
+    });
+
+    measure(label + "wamp_request_table", CALLS, [&]() {
+        autobahn::wamp_request_table<autobahn::wamp_call> calls;
+        uint64_t request_id = 0;
+        for (std::size_t i = 0; i < outstanding; ++i) {
+            calls.emplace(++request_id);
+        }
+        for (std::size_t i = 0; i < CALLS; ++i) {
+            auto call = calls.take(request_id - outstanding + 1);
+            calls.emplace(++request_id);
+        }
+        benchmark_sink = calls.size();
+    });
+}
+
+} // namespace
+
+int main()
+{
+    for (std::size_t outstanding : {100, 10000, 100000}) {
+        compare(outstanding);
+    }
+    return 0;
+}
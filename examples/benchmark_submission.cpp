@@ -0,0 +1,222 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Crossbar.io Technologies GmbH and contributors
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "benchmark.hpp"
+#include "loopback_router.hpp"
+
+#include <autobahn/autobahn.hpp>
+#include <autobahn/wamp_submission_queue.hpp>
+#include <boost/asio.hpp>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+// Publishes from 1, 4 and 16 application threads at once, on a session
+// attached to a loopback router, and compares how the operations get to the
+// session's strand: through the submission ring and one drain handler per
+// burst, as the session does now, or through one asio handler per operation,
+// as the session used to.
+
+namespace {
+
+const std::size_t EVENTS = 160000;
+
+// Hands operations to a strand the way wamp_session::submit() does, with the
+// same ring, drain handler and overflow list.
+class ring_handoff
+{
+public:
+    explicit ring_handoff(boost::asio::io_service& io)
+        : m_strand(io)
+        , m_submissions(4096)
+        , m_drain_scheduled(false)
+        , m_overflow_mutex()
+        , m_overflow()
+        , m_overflowing(false)
+    {
+    }
+
+    template <typename Operation>
+    void submit(Operation&& operation)
+    {
+        auto submission = autobahn::make_submission(std::forward<Operation>(operation));
+        if (m_overflowing.load(std::memory_order_acquire) || !m_submissions.try_push(std::move(submission))) {
+            std::lock_guard<std::mutex> lock(m_overflow_mutex);
+            m_overflow.push_back(std::move(submission));
+            m_overflowing.store(true, std::memory_order_release);
+        }
+
+        if (!m_drain_scheduled.exchange(true)) {
+            m_strand.post([this]() { drain(); });
+        }
+    }
+
+private:
+    void drain()
+    {
+        do {
+            std::unique_ptr<autobahn::wamp_submission> submission;
+            while (m_submissions.try_pop(submission)) {
+                submission->run();
+                submission.reset();
+            }
+
+            if (m_overflowing.load(std::memory_order_acquire)) {
+                std::vector<std::unique_ptr<autobahn::wamp_submission>> overflow;
+                {
+                    std::lock_guard<std::mutex> lock(m_overflow_mutex);
+                    overflow.swap(m_overflow);
+                    m_overflowing.store(false, std::memory_order_release);
+                }
+                for (auto& held : overflow) {
+                    held->run();
+                }
+            }
+            m_drain_scheduled.store(false);
+        } while ((m_submissions.ready() || m_overflowing.load(std::memory_order_acquire))
+                && !m_drain_scheduled.exchange(true));
+    }
+
+    boost::asio::io_service::strand m_strand;
+    autobahn::wamp_submission_queue<std::unique_ptr<autobahn::wamp_submission>> m_submissions;
+    std::atomic<bool> m_drain_scheduled;
+    std::mutex m_overflow_mutex;
+    std::vector<std::unique_ptr<autobahn::wamp_submission>> m_overflow;
+    std::atomic<bool> m_overflowing;
+};
+
+// Runs @p produce on each of @p threads threads with its share of the events.
+template <typename Produce>
+void run_producers(std::size_t threads, Produce&& produce)
+{
+    std::vector<std::thread> producers;
+    for (std::size_t t = 0; t < threads; ++t) {
+        producers.emplace_back([&produce, threads]() { produce(EVENTS / threads); });
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+}
+
+// Hands the events from @p threads threads to a strand, through the ring or
+// per operation, and waits until the strand has seen them all.
+void compare_handoff(boost::asio::io_service& io, std::size_t threads)
+{
+    const std::string topic("com.examples.ticks");
+    const std::string label = std::to_string(threads) + " thread(s) ";
+
+    // Each operation carries a topic and an argument, as a publication does.
+    uint64_t received = 0;
+    auto operation = [&received, &topic](uint64_t tick) {
+        return [&received, topic, tick]() { received += topic.size() + tick; };
+    };
+
+    boost::asio::io_service::strand strand(io);
+    measure(label + "hand-off per operation", EVENTS, [&]() {
+        run_producers(threads, [&](std::size_t events) {
+            for (std::size_t i = 0; i < events; ++i) {
+                boost::asio::dispatch(strand, operation(i));
+            }
+        });
+        boost::promise<void> done;
+        boost::asio::dispatch(strand, [&done]() { done.set_value(); });
+        done.get_future().get();
+    });
+
+    ring_handoff ring(io);
+    measure(label + "hand-off through the ring", EVENTS, [&]() {
+        run_producers(threads, [&](std::size_t events) {
+            for (std::size_t i = 0; i < events; ++i) {
+                ring.submit(operation(i));
+            }
+        });
+        boost::promise<void> done;
+        ring.submit([&done]() { done.set_value(); });
+        done.get_future().get();
+    });
+
+    benchmark_sink = static_cast<double>(received);
+}
+
+} // namespace
+
+int main()
+{
+    boost::asio::io_service io;
+    std::unique_ptr<boost::asio::io_service::work> work(new boost::asio::io_service::work(io));
+    std::thread io_thread([&io]() { io.run(); });
+
+    auto router = std::make_shared<loopback_router>(io);
+    auto session = std::make_shared<autobahn::wamp_session>(io);
+    router->attach(std::static_pointer_cast<autobahn::wamp_transport_handler>(session));
+
+    bool stopped = false;
+    try {
+        router->connect().get();
+        session->start().get();
+        session->join("realm1").get();
+
+        for (std::size_t threads : {1, 4, 16}) {
+            compare_handoff(io, threads);
+
+            measure(std::to_string(threads) + " thread(s) publish", EVENTS, [&]() {
+                run_producers(threads, [&](std::size_t events) {
+                    std::vector<boost::future<void>> publications;
+                    publications.reserve(events);
+                    for (std::size_t i = 0; i < events; ++i) {
+                        publications.push_back(session->publish("com.examples.ticks", std::make_tuple(uint64_t(i))));
+                    }
+                    for (auto& publication : publications) {
+                        publication.get();
+                    }
+                });
+            });
+        }
+
+        session->leave().get();
+        session->stop().get();
+        router->detach();
+        stopped = true;
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        io.stop();
+    }
+
+    // The io thread is joined however the run ended.
+    work.reset();
+    io_thread.join();
+    return stopped ? 0 : 1;
+}
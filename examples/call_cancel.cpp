@@ -0,0 +1,180 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Crossbar.io Technologies GmbH and contributors
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "loopback_router.hpp"
+
+#include <autobahn/autobahn.hpp>
+#include <boost/asio.hpp>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <tuple>
+
+// Cancels calls in each of the three cancel modes against a loopback router
+// and checks what the caller, the dealer and the callee see of it.
+
+namespace {
+
+std::mutex invoked_mutex;
+autobahn::wamp_invocation invoked;
+std::atomic<int> interrupted(0);
+
+void slow(autobahn::wamp_invocation invocation)
+{
+    // Replies only once told to, or not at all when interrupted.
+    invocation->on_cancel([]() { ++interrupted; });
+    std::lock_guard<std::mutex> lock(invoked_mutex);
+    invoked = invocation;
+}
+
+void echo(autobahn::wamp_invocation invocation)
+{
+    invocation->result(std::make_tuple(invocation->argument<uint64_t>(0)));
+}
+
+bool wait_until(const std::function<bool()>& condition)
+{
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!condition()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+bool cancel_call(
+        const std::shared_ptr<autobahn::wamp_session>& session,
+        const std::shared_ptr<loopback_router>& router,
+        autobahn::wamp_cancel_mode mode)
+{
+    const char* name = autobahn::cancel_mode_name(mode);
+    {
+        std::lock_guard<std::mutex> lock(invoked_mutex);
+        invoked.reset();
+    }
+    interrupted = 0;
+    const std::size_t interrupts = router->interrupts();
+
+    autobahn::wamp_call_handle handle;
+    autobahn::wamp_call_options options;
+    options.set_handle(handle);
+    auto result = session->call("com.examples.slow", std::make_tuple(), options);
+
+    if (!wait_until([]() { std::lock_guard<std::mutex> lock(invoked_mutex); return invoked != nullptr; })) {
+        std::cerr << name << ": procedure not invoked" << std::endl;
+        return false;
+    }
+
+    handle.cancel(mode);
+    try {
+        result.get();
+        std::cerr << name << ": call not canceled" << std::endl;
+        return false;
+    } catch (const autobahn::canceled_error&) {
+    }
+
+    if (mode == autobahn::wamp_cancel_mode::skip) {
+        // The callee goes on, and the dealer drops its result.
+        if (router->interrupts() != interrupts || router->pending_calls() != 1) {
+            std::cerr << name << ": callee interrupted" << std::endl;
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(invoked_mutex);
+        invoked->result(std::make_tuple());
+    } else if (!wait_until([]() { return interrupted == 1; })
+            || router->interrupts() != interrupts + 1) {
+        std::cerr << name << ": callee not interrupted" << std::endl;
+        return false;
+    }
+
+    // With kill the dealer waits for the callee's error, which the session
+    // sends on being interrupted.
+    if (!wait_until([&]() { return router->pending_calls() == 0; })) {
+        std::cerr << name << ": call still pending at the dealer" << std::endl;
+        return false;
+    }
+
+    // Whatever the dealer answered for the canceled call, the session stays usable.
+    uint64_t echoed = session->call("com.examples.echo", std::make_tuple(uint64_t(23))).get().argument<uint64_t>(0);
+    if (echoed != 23) {
+        std::cerr << name << ": echo returned " << echoed << std::endl;
+        return false;
+    }
+
+    std::cerr << name << ": ok" << std::endl;
+    return true;
+}
+
+} // namespace
+
+int main()
+{
+    boost::asio::io_service io;
+    std::unique_ptr<boost::asio::io_service::work> work(new boost::asio::io_service::work(io));
+    std::thread io_thread([&io]() { io.run(); });
+
+    auto router = std::make_shared<loopback_router>(io);
+    auto session = std::make_shared<autobahn::wamp_session>(io);
+    router->attach(std::static_pointer_cast<autobahn::wamp_transport_handler>(session));
+
+    bool passed = false;
+    try {
+        router->connect().get();
+        session->start().get();
+        session->join("realm1").get();
+        session->provide("com.examples.slow", &slow).get();
+        session->provide("com.examples.echo", &echo).get();
+
+        passed = cancel_call(session, router, autobahn::wamp_cancel_mode::skip)
+                && cancel_call(session, router, autobahn::wamp_cancel_mode::kill)
+                && cancel_call(session, router, autobahn::wamp_cancel_mode::killnowait);
+
+        session->leave().get();
+        session->stop().get();
+        router->detach();
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        passed = false;
+        io.stop();
+    }
+
+    // The io thread is joined however the checks ended.
+    work.reset();
+    io_thread.join();
+
+    return passed ? 0 : 1;
+}
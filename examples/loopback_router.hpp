@@ -0,0 +1,432 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Crossbar.io Technologies GmbH and contributors
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef EXAMPLES_LOOPBACK_ROUTER_HPP
+#define EXAMPLES_LOOPBACK_ROUTER_HPP
+
+#include <autobahn/autobahn.hpp>
+#include <boost/asio/io_service.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/strand.hpp>
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/*!
+ * An in-process stand-in for a WAMP router, attached to a session in place of
+ * a network transport.
+ *
+ * It plays broker and dealer for the one session attached: events are
+ * delivered back to the session's own subscriptions and calls are routed to
+ * the session's own registrations. Call canceling is supported in all three
+ * modes. Replies are posted in order through a strand of the given io service,
+ * so the session sees them arrive as it would from a network transport.
+ */
+class loopback_router :
+    public autobahn::wamp_transport,
+    public std::enable_shared_from_this<loopback_router>
+{
+public:
+    explicit loopback_router(boost::asio::io_service& io)
+        : m_strand(io)
+        , m_connected(false)
+        , m_next_id(0)
+        , m_interrupts(0)
+    {
+    }
+
+    boost::future<void> connect() override
+    {
+        m_connected = true;
+        return boost::make_ready_future();
+    }
+
+    boost::future<void> disconnect() override
+    {
+        m_connected = false;
+        return boost::make_ready_future();
+    }
+
+    bool is_connected() const override
+    {
+        return m_connected;
+    }
+
+    void send_message(autobahn::wamp_message&& message) override
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        route(message);
+    }
+
+    void set_pause_handler(pause_handler&& /*handler*/) override {}
+    void set_resume_handler(resume_handler&& /*handler*/) override {}
+    void pause() override {}
+    void resume() override {}
+
+    void attach(const std::shared_ptr<autobahn::wamp_transport_handler>& handler) override
+    {
+        if (m_handler) {
+            throw std::logic_error("handler already attached");
+        }
+        m_handler = handler;
+        m_handler->on_attach(shared_from_this());
+    }
+
+    void detach() override
+    {
+        if (!m_handler) {
+            throw std::logic_error("no handler attached");
+        }
+        m_handler->on_detach(true, "wamp.error.goodbye");
+        m_handler.reset();
+    }
+
+    bool has_handler() const override
+    {
+        return m_handler != nullptr;
+    }
+
+    /*!
+     * The number of calls the dealer still waits to answer.
+     */
+    std::size_t pending_calls() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_calls.size();
+    }
+
+    /*!
+     * The number of INTERRUPT messages sent to the callee.
+     */
+    std::size_t interrupts() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_interrupts;
+    }
+
+private:
+    using message_type = autobahn::message_type;
+    using no_details = std::map<int, int>;
+
+    // A call routed to the callee, by invocation request id.
+    struct pending_call
+    {
+        uint64_t request_id;
+        bool answered;
+    };
+
+    void route(autobahn::wamp_message& message)
+    {
+        switch (static_cast<message_type>(message.field<int>(0))) {
+            case message_type::HELLO:
+                welcome();
+                break;
+            case message_type::GOODBYE:
+                goodbye();
+                break;
+            case message_type::SUBSCRIBE:
+                subscribe(message);
+                break;
+            case message_type::UNSUBSCRIBE:
+                acknowledge(message_type::UNSUBSCRIBED, message.field<uint64_t>(1));
+                break;
+            case message_type::PUBLISH:
+                publish(message);
+                break;
+            case message_type::REGISTER:
+                enroll(message);
+                break;
+            case message_type::UNREGISTER:
+                acknowledge(message_type::UNREGISTERED, message.field<uint64_t>(1));
+                break;
+            case message_type::CALL:
+                call(message);
+                break;
+            case message_type::CANCEL:
+                cancel(message);
+                break;
+            case message_type::YIELD:
+                yield(message);
+                break;
+            case message_type::ERROR:
+                invocation_error(message);
+                break;
+            default:
+                break;
+        }
+    }
+
+    void welcome()
+    {
+        using features = std::map<std::string, bool>;
+        using role = std::map<std::string, features>;
+        std::map<std::string, std::map<std::string, role>> details;
+        details["roles"]["broker"]["features"] = features();
+        details["roles"]["dealer"]["features"]["call_canceling"] = true;
+
+        // [WELCOME, Session|id, Details|dict]
+        autobahn::wamp_message welcome(3);
+        welcome.set_field(0, static_cast<int>(message_type::WELCOME));
+        welcome.set_field(1, uint64_t(1));
+        welcome.set_field(2, details);
+        deliver(std::move(welcome));
+    }
+
+    void goodbye()
+    {
+        // [GOODBYE, Details|dict, Reason|uri]
+        autobahn::wamp_message goodbye(3);
+        goodbye.set_field(0, static_cast<int>(message_type::GOODBYE));
+        goodbye.set_field(1, no_details());
+        goodbye.set_field(2, std::string("wamp.close.goodbye_and_out"));
+        deliver(std::move(goodbye));
+    }
+
+    void subscribe(autobahn::wamp_message& message)
+    {
+        // [SUBSCRIBE, Request|id, Options|dict, Topic|uri]
+        uint64_t subscription_id = ++m_next_id;
+        m_subscriptions.emplace(message.field<std::string>(3), subscription_id);
+
+        // [SUBSCRIBED, SUBSCRIBE.Request|id, Subscription|id]
+        autobahn::wamp_message subscribed(3);
+        subscribed.set_field(0, static_cast<int>(message_type::SUBSCRIBED));
+        subscribed.set_field(1, message.field<uint64_t>(1));
+        subscribed.set_field(2, subscription_id);
+        deliver(std::move(subscribed));
+    }
+
+    void publish(autobahn::wamp_message& message)
+    {
+        // [PUBLISH, Request|id, Options|dict, Topic|uri, Arguments|list, ArgumentsKw|dict]
+        uint64_t publication_id = ++m_next_id;
+        auto range = m_subscriptions.equal_range(message.field<std::string>(3));
+        for (auto subscription = range.first; subscription != range.second; ++subscription) {
+            // [EVENT, SUBSCRIBED.Subscription|id, PUBLISHED.Publication|id, Details|dict,
+            //     PUBLISH.Arguments|list, PUBLISH.ArgumentKw|dict]
+            autobahn::wamp_message event(message.size());
+            event.set_field(0, static_cast<int>(message_type::EVENT));
+            event.set_field(1, subscription->second);
+            event.set_field(2, publication_id);
+            event.set_field(3, no_details());
+            for (std::size_t i = 4; i < message.size(); ++i) {
+                event.set_field(i, message.field(i));
+            }
+            deliver(std::move(event));
+        }
+
+        if (autobahn::value_for_key_or(message.field(2), "acknowledge", false)) {
+            // [PUBLISHED, PUBLISH.Request|id, Publication|id]
+            autobahn::wamp_message published(3);
+            published.set_field(0, static_cast<int>(message_type::PUBLISHED));
+            published.set_field(1, message.field<uint64_t>(1));
+            published.set_field(2, publication_id);
+            deliver(std::move(published));
+        }
+    }
+
+    void enroll(autobahn::wamp_message& message)
+    {
+        // [REGISTER, Request|id, Options|dict, Procedure|uri]
+        uint64_t registration_id = ++m_next_id;
+        m_registrations[message.field<std::string>(3)] = registration_id;
+
+        // [REGISTERED, REGISTER.Request|id, Registration|id]
+        autobahn::wamp_message registered(3);
+        registered.set_field(0, static_cast<int>(message_type::REGISTERED));
+        registered.set_field(1, message.field<uint64_t>(1));
+        registered.set_field(2, registration_id);
+        deliver(std::move(registered));
+    }
+
+    void acknowledge(message_type type, uint64_t request_id)
+    {
+        // [UNSUBSCRIBED, UNSUBSCRIBE.Request|id] or [UNREGISTERED, UNREGISTER.Request|id]
+        autobahn::wamp_message reply(2);
+        reply.set_field(0, static_cast<int>(type));
+        reply.set_field(1, request_id);
+        deliver(std::move(reply));
+    }
+
+    void call(autobahn::wamp_message& message)
+    {
+        // [CALL, Request|id, Options|dict, Procedure|uri, Arguments|list, ArgumentsKw|dict]
+        uint64_t request_id = message.field<uint64_t>(1);
+        auto registration = m_registrations.find(message.field<std::string>(3));
+        if (registration == m_registrations.end()) {
+            error(request_id, "wamp.error.no_such_procedure");
+            return;
+        }
+
+        uint64_t invocation_id = ++m_next_id;
+        m_calls[invocation_id] = pending_call{request_id, false};
+
+        // [INVOCATION, Request|id, REGISTERED.Registration|id, Details|dict,
+        //     CALL.Arguments|list, CALL.ArgumentsKw|dict]
+        autobahn::wamp_message invocation(message.size());
+        invocation.set_field(0, static_cast<int>(message_type::INVOCATION));
+        invocation.set_field(1, invocation_id);
+        invocation.set_field(2, registration->second);
+        invocation.set_field(3, no_details());
+        for (std::size_t i = 4; i < message.size(); ++i) {
+            invocation.set_field(i, message.field(i));
+        }
+        deliver(std::move(invocation));
+    }
+
+    void cancel(autobahn::wamp_message& message)
+    {
+        // [CANCEL, CALL.Request|id, Options|dict]
+        uint64_t request_id = message.field<uint64_t>(1);
+        auto mode = autobahn::cancel_mode_from_name(
+                autobahn::value_for_key_or(message.field(2), "mode", std::string()));
+
+        auto pending = m_calls.begin();
+        while (pending != m_calls.end() && pending->second.request_id != request_id) {
+            ++pending;
+        }
+        if (pending == m_calls.end() || pending->second.answered) {
+            return;
+        }
+
+        // With skip and killnowait the caller is answered right away, and whatever
+        // the callee replies is dropped. With kill the answer waits for the callee.
+        if (mode != autobahn::wamp_cancel_mode::kill) {
+            error(request_id, "wamp.error.canceled");
+            pending->second.answered = true;
+        }
+
+        if (mode == autobahn::wamp_cancel_mode::skip) {
+            return;
+        }
+
+        // [INTERRUPT, INVOCATION.Request|id, Options|dict]
+        std::map<std::string, std::string> options;
+        options["mode"] = autobahn::cancel_mode_name(mode);
+        autobahn::wamp_message interrupt(3);
+        interrupt.set_field(0, static_cast<int>(message_type::INTERRUPT));
+        interrupt.set_field(1, pending->first);
+        interrupt.set_field(2, options);
+        deliver(std::move(interrupt));
+        ++m_interrupts;
+
+        // The callee does not reply to a killnowait.
+        if (mode == autobahn::wamp_cancel_mode::killnowait) {
+            m_calls.erase(pending);
+        }
+    }
+
+    void yield(autobahn::wamp_message& message)
+    {
+        // [YIELD, INVOCATION.Request|id, Options|dict, Arguments|list, ArgumentsKw|dict]
+        auto pending = m_calls.find(message.field<uint64_t>(1));
+        if (pending == m_calls.end()) {
+            return;
+        }
+
+        const bool progress = autobahn::value_for_key_or(message.field(2), "progress", false);
+        if (!pending->second.answered) {
+            std::map<std::string, bool> details;
+            if (progress) {
+                details["progress"] = true;
+            }
+
+            // [RESULT, CALL.Request|id, Details|dict, YIELD.Arguments|list, YIELD.ArgumentsKw|dict]
+            autobahn::wamp_message result(message.size());
+            result.set_field(0, static_cast<int>(message_type::RESULT));
+            result.set_field(1, pending->second.request_id);
+            result.set_field(2, details);
+            for (std::size_t i = 3; i < message.size(); ++i) {
+                result.set_field(i, message.field(i));
+            }
+            deliver(std::move(result));
+        }
+
+        if (!progress) {
+            m_calls.erase(pending);
+        }
+    }
+
+    void invocation_error(autobahn::wamp_message& message)
+    {
+        // [ERROR, INVOCATION, INVOCATION.Request|id, Details|dict, Error|uri]
+        if (message.field<int>(1) != static_cast<int>(message_type::INVOCATION)) {
+            return;
+        }
+
+        auto pending = m_calls.find(message.field<uint64_t>(2));
+        if (pending == m_calls.end()) {
+            return;
+        }
+
+        if (!pending->second.answered) {
+            error(pending->second.request_id, message.field<std::string>(4));
+        }
+        m_calls.erase(pending);
+    }
+
+    void error(uint64_t request_id, const std::string& uri)
+    {
+        // [ERROR, CALL, CALL.Request|id, Details|dict, Error|uri]
+        autobahn::wamp_message error(5);
+        error.set_field(0, static_cast<int>(message_type::ERROR));
+        error.set_field(1, static_cast<int>(message_type::CALL));
+        error.set_field(2, request_id);
+        error.set_field(3, no_details());
+        error.set_field(4, uri);
+        deliver(std::move(error));
+    }
+
+    void deliver(autobahn::wamp_message&& message)
+    {
+        auto handler = m_handler;
+        auto shared_message = std::make_shared<autobahn::wamp_message>(std::move(message));
+        boost::asio::post(m_strand, [handler, shared_message]() {
+            handler->on_message(std::move(*shared_message));
+        });
+    }
+
+    boost::asio::io_service::strand m_strand;
+    std::shared_ptr<autobahn::wamp_transport_handler> m_handler;
+    std::atomic<bool> m_connected;
+
+    mutable std::mutex m_mutex;
+    uint64_t m_next_id;
+    std::multimap<std::string, uint64_t> m_subscriptions;
+    std::unordered_map<std::string, uint64_t> m_registrations;
+    std::map<uint64_t, pending_call> m_calls;
+    std::size_t m_interrupts;
+};
+
+#endif // EXAMPLES_LOOPBACK_ROUTER_HPP
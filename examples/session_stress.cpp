@@ -0,0 +1,176 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Crossbar.io Technologies GmbH and contributors
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "loopback_router.hpp"
+
+#include <autobahn/autobahn.hpp>
+#include <boost/asio.hpp>
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+// Drives one session from several application threads at once, against a
+// loopback router served by several io threads: publications, calls to a
+// pooled procedure, corking and changes of the publish window and of the
+// invocation pool all race each other. Build with -fsanitize=thread to have
+// the session's thread safety checked, the example itself checks that nothing
+// is lost or answered wrongly.
+
+namespace {
+
+const int APPLICATION_THREADS = 4;
+const int IO_THREADS = 4;
+const int ITERATIONS = 2000;
+
+void echo(autobahn::wamp_invocation invocation)
+{
+    invocation->result(std::make_tuple(invocation->argument<uint64_t>(0)));
+}
+
+// Publishes and calls from one application thread, then checks the results.
+void produce(const std::shared_ptr<autobahn::wamp_session>& session, int t, std::atomic<bool>& failed)
+{
+    try {
+        autobahn::wamp_publish_options acknowledged;
+        acknowledged.set_acknowledge(true);
+
+        std::vector<boost::future<void>> publications;
+        std::vector<boost::future<autobahn::wamp_call_result>> calls;
+        for (int i = 0; i < ITERATIONS; ++i) {
+            const uint64_t value = uint64_t(t) * ITERATIONS + i;
+            if (i % 100 == 0) {
+                // A corked burst goes out as one batch.
+                autobahn::wamp_session::cork_scope cork(*session);
+                for (int j = 0; j < 10; ++j) {
+                    session->publish("com.examples.ticks", std::make_tuple(value));
+                }
+            }
+            if (t == 0 && i % 50 == 0) {
+                session->set_publish_window(1 + (i / 50) % 8);
+            }
+            if (t == 1 && i % 500 == 0) {
+                // Procedures provided from now on run on another pool; the
+                // one provided before keeps its pool.
+                session->set_invocation_pool(std::make_shared<autobahn::wamp_invocation_pool>(1));
+                session->provide("com.examples.echo." + std::to_string(i), &echo).get();
+            }
+
+            publications.push_back(session->publish(
+                    "com.examples.ticks", std::make_tuple(value), acknowledged));
+            calls.push_back(session->call("com.examples.echo", std::make_tuple(value)));
+        }
+
+        for (auto& publication : publications) {
+            publication.get();
+        }
+        for (int i = 0; i < ITERATIONS; ++i) {
+            const uint64_t value = uint64_t(t) * ITERATIONS + i;
+            if (calls[i].get().argument<uint64_t>(0) != value) {
+                std::cerr << "wrong result for " << value << std::endl;
+                failed = true;
+            }
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        failed = true;
+    }
+}
+
+} // namespace
+
+int main()
+{
+    boost::asio::io_service io;
+    std::unique_ptr<boost::asio::io_service::work> work(new boost::asio::io_service::work(io));
+    std::vector<std::thread> io_threads;
+    for (int i = 0; i < IO_THREADS; ++i) {
+        io_threads.emplace_back([&io]() { io.run(); });
+    }
+
+    auto router = std::make_shared<loopback_router>(io);
+    auto session = std::make_shared<autobahn::wamp_session>(io);
+    router->attach(std::static_pointer_cast<autobahn::wamp_transport_handler>(session));
+
+    std::atomic<bool> failed(false);
+    try {
+        router->connect().get();
+        session->start().get();
+        session->join("realm1").get();
+
+        std::atomic<uint64_t> received(0);
+        auto subscription = session->subscribe("com.examples.ticks",
+                [&received](const autobahn::wamp_event&) { ++received; }).get();
+
+        session->set_invocation_pool(std::make_shared<autobahn::wamp_invocation_pool>(2));
+        session->provide("com.examples.echo", &echo).get();
+
+        std::vector<std::thread> application_threads;
+        for (int t = 0; t < APPLICATION_THREADS; ++t) {
+            application_threads.emplace_back([&session, &failed, t]() { produce(session, t, failed); });
+        }
+        for (auto& thread : application_threads) {
+            thread.join();
+        }
+
+        // Every publication, corked or acknowledged, is delivered back once. The
+        // acknowledgements arrive after the events, so all events are in.
+        const uint64_t published = uint64_t(APPLICATION_THREADS) * (ITERATIONS + ITERATIONS / 100 * 10);
+        if (received != published) {
+            std::cerr << "received " << received << " of " << published << " events" << std::endl;
+            failed = true;
+        }
+
+        session->unsubscribe(subscription).get();
+        session->set_invocation_pool(nullptr);
+        session->leave().get();
+        session->stop().get();
+        router->detach();
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        failed = true;
+        io.stop();
+    }
+
+    // The io threads are joined however the run ended.
+    work.reset();
+    for (auto& thread : io_threads) {
+        thread.join();
+    }
+
+    std::cerr << (failed ? "failed" : "ok") << std::endl;
+    return failed ? 1 : 0;
+}